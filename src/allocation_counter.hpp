@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace hyp {
+
+    /**
+     * 🧮 Heap allocations made through global operator new, across all threads.
+     * Only counts in a program where exactly one translation unit defines
+     * HYP_COUNT_ALLOCATIONS before including this header, everywhere else it stays at zero.
+     */
+    struct AllocationCounter {
+        static inline std::atomic<std::size_t> allocations{0};
+        static inline std::atomic<std::size_t> bytes{0};
+        static inline bool enabled = false;
+    };
+
+    /**
+     * 📏 Allocations made between construction and count(), and the bytes they asked for
+     */
+    class AllocationScope {
+    public:
+        AllocationScope() :
+            start{AllocationCounter::allocations.load(std::memory_order_relaxed)},
+            start_bytes{AllocationCounter::bytes.load(std::memory_order_relaxed)} {
+        }
+
+        std::size_t count() const {
+            return AllocationCounter::allocations.load(std::memory_order_relaxed) - start;
+        }
+
+        std::size_t bytes() const {
+            return AllocationCounter::bytes.load(std::memory_order_relaxed) - start_bytes;
+        }
+
+    private:
+        const std::size_t start;
+        const std::size_t start_bytes;
+    };
+}
+
+#if defined(HYP_COUNT_ALLOCATIONS)
+
+static const bool hyp_allocations_counted = (hyp::AllocationCounter::enabled = true);
+
+void* operator new(std::size_t size) {
+    hyp::AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    hyp::AllocationCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
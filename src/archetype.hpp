@@ -0,0 +1,340 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#include "entity.hpp"
+#include "thread_pool.hpp"
+
+namespace hyp {
+
+    /**
+     * 🗃 Structure-of-arrays storage for every entity that shares the component set T...
+     * Each component type gets its own contiguous column, so a system touching only
+     * Physics streams through Physics and never drags Health into cache.
+     * Rows stay dense: removing one moves the last row into the hole (swap-and-pop),
+     * so a row index is only stable until the next removal.
+     */
+    template<typename... T>
+    class Archetype {
+    public:
+        using Components = std::tuple<T...>;
+        std::tuple<std::vector<T>...> columns;
+
+        template<typename Component>
+        static constexpr bool has = (std::is_same_v<Component, T> || ...);
+
+        std::size_t size() const {
+            return std::get<0>(columns).size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        void reserve(std::size_t count) {
+            (std::get<std::vector<T>>(columns).reserve(count), ...);
+        }
+
+        void clear() {
+            (std::get<std::vector<T>>(columns).clear(), ...);
+        }
+
+        template<typename Component>
+        std::span<Component> column() {
+            constexpr std::size_t index =
+                    tuple_element_index_v<Component, Components>;
+            return std::get<index>(columns);
+        }
+
+        template<typename Component>
+        std::span<const Component> column() const {
+            constexpr std::size_t index =
+                    tuple_element_index_v<Component, Components>;
+            return std::get<index>(columns);
+        }
+
+        template<typename Component>
+        Component get(std::size_t row) const {
+            return column<Component>()[row];
+        }
+
+        template<typename Component>
+        Component& get_ref(std::size_t row) {
+            return column<Component>()[row];
+        }
+
+        template<typename... Component>
+        std::tuple<Component&...> get_many(std::size_t row) {
+            return std::tie(get_ref<Component>(row)...);
+        }
+
+        template<typename Component, typename Modifier>
+        void modify(std::size_t row, Modifier&& modifier) {
+            modifier(get_ref<Component>(row));
+        }
+
+        template<typename Component>
+        void set(std::size_t row, Component&& component) {
+            get_ref<std::remove_cvref_t<Component>>(row) = std::forward<Component>(component);
+        }
+
+        template<typename... Component>
+        void set_many(std::size_t row, Component&&... component) {
+            (set(row, std::forward<Component>(component)), ...);
+        }
+
+        /**
+         * ➕ Append one row, returns its index
+         */
+        std::size_t add(T... components) {
+            (std::get<std::vector<T>>(columns).push_back(std::move(components)), ...);
+            return size() - 1;
+        }
+
+        std::size_t add(const Entity<T...>& entity) {
+            return std::apply([this](const T&... components) {
+                return add(components...);
+            }, entity.components);
+        }
+
+        /**
+         * ➕ Append a block of rows column by column, returns the index of the first one.
+         * Every span has to be the same length.
+         */
+        std::size_t add_many(std::span<const T>... components) {
+            const std::size_t first = size();
+            [[maybe_unused]] const std::size_t count = std::get<0>(std::forward_as_tuple(components...)).size();
+            assert(((components.size() == count) && ...));
+            (std::get<std::vector<T>>(columns).insert(
+                    std::get<std::vector<T>>(columns).end(),
+                    components.begin(), components.end()), ...);
+            return first;
+        }
+
+        /**
+         * ➕ Append `count` copies of the same row, returns the index of the first one
+         */
+        std::size_t add_many(std::size_t count, const T&... components) {
+            const std::size_t first = size();
+            (std::get<std::vector<T>>(columns).resize(first + count, components), ...);
+            return first;
+        }
+
+        /**
+         * ➖ Swap-and-pop: the last row moves into `row`
+         */
+        void remove(std::size_t row) {
+            assert(row < size());
+            const std::size_t last = size() - 1;
+            ([&](std::vector<T>& column) {
+                if (row != last) {
+                    column[row] = std::move(column[last]);
+                }
+                column.pop_back();
+            }(std::get<std::vector<T>>(columns)), ...);
+        }
+
+        /**
+         * ➖ Remove a set of rows, `rows` has to be sorted ascending without duplicates.
+         * Walking from the back means the row swapped into a hole is never one still
+         * waiting to be removed.
+         */
+        void remove_many(std::span<const std::size_t> rows) {
+            for (auto row = rows.rbegin(); row != rows.rend(); ++row) {
+                remove(*row);
+            }
+        }
+
+        /**
+         * ➖ Remove every row where predicate(components...) holds, returns how many went.
+         * Only the listed component columns are read while scanning.
+         */
+        template<typename... Component, typename Predicate>
+        std::size_t remove_if(Predicate predicate) {
+            const std::size_t before = size();
+            std::size_t row = 0;
+            while (row < size()) {
+                if (predicate(column<Component>()[row]...)) {
+                    remove(row);
+                } else {
+                    ++row;
+                }
+            }
+            return before - size();
+        }
+    };
+
+    template<typename StoreType, typename... Component>
+    class View;
+
+    /**
+     * 🗄 Entities grouped by component set, one Archetype per set
+     */
+    template<typename... Archetypes>
+    class Store {
+    public:
+        std::tuple<Archetypes...> archetypes;
+
+        template<typename... Component>
+        View<Store, Component...> view() {
+            return View<Store, Component...>{*this};
+        }
+
+        template<typename... Component>
+        Archetype<Component...>& archetype() {
+            constexpr std::size_t index =
+                    tuple_element_index_v<Archetype<Component...>, std::tuple<Archetypes...>>;
+            return std::get<index>(archetypes);
+        }
+
+        template<typename... Component>
+        std::size_t add(Component... components) {
+            return archetype<Component...>().add(components...);
+        }
+
+        template<typename... Component>
+        std::size_t add(const Entity<Component...>& entity) {
+            return archetype<Component...>().add(entity);
+        }
+
+        std::size_t size() const {
+            return std::apply([](const Archetypes&... archetype) {
+                return (archetype.size() + ... + 0);
+            }, archetypes);
+        }
+    };
+
+    /**
+     * 🔭 Every archetype in a Store holding all of Component..., picked at compile time.
+     * Callbacks get references straight into the columns, nothing is copied.
+     */
+    template<typename StoreType, typename... Component>
+    class View {
+    public:
+        StoreType& store;
+
+        template<typename ArchetypeType>
+        static constexpr bool matches = (ArchetypeType::template has<Component> && ...);
+
+        /**
+         * 🗃 body(Archetype&) once per matching archetype, for structural changes
+         */
+        template<typename Body>
+        void each_archetype(Body&& body) {
+            std::apply([&body](auto&... archetype) {
+                ([&body](auto& archetype) {
+                    if constexpr (matches<std::remove_reference_t<decltype(archetype)>>) {
+                        body(archetype);
+                    }
+                }(archetype), ...);
+            }, store.archetypes);
+        }
+
+        /**
+         * 🧱 body(span<Component>...) once per non-empty matching archetype
+         */
+        template<typename Body>
+        void each_chunk(Body&& body) {
+            each_archetype([&body](auto& archetype) {
+                if (!archetype.empty()) {
+                    body(archetype.template column<Component>()...);
+                }
+            });
+        }
+
+        /**
+         * 🧱🔀 Like each_chunk, but with every archetype cut into sub-spans of `grain` rows
+         * spread across the pool
+         */
+        template<typename Body>
+        void par_each_chunk(ThreadPool& pool, Body&& body, std::size_t grain = 4096) {
+            each_chunk([&](std::span<Component>... columns) {
+                const std::size_t count = std::get<0>(std::forward_as_tuple(columns...)).size();
+                pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+                    body(columns.subspan(begin, end - begin)...);
+                });
+            });
+        }
+
+        /**
+         * 🔁 body(Component&...) once per matching entity
+         */
+        template<typename Body>
+        void each(Body&& body) {
+            each_chunk([&body](std::span<Component>... columns) {
+                const std::size_t count = std::get<0>(std::forward_as_tuple(columns...)).size();
+                for (std::size_t row = 0; row < count; ++row) {
+                    body(columns[row]...);
+                }
+            });
+        }
+
+        /**
+         * 🔀 Like each, but rows are split into chunks of `grain` across the pool.
+         * body must be safe to call concurrently for different rows.
+         */
+        template<typename Body>
+        void par_each(ThreadPool& pool, Body&& body, std::size_t grain = 4096) {
+            each_chunk([&](std::span<Component>... columns) {
+                const std::size_t count = std::get<0>(std::forward_as_tuple(columns...)).size();
+                pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t row = begin; row < end; ++row) {
+                        body(columns[row]...);
+                    }
+                });
+            });
+        }
+
+        template<typename Body>
+        void par_each(Body&& body, std::size_t grain = 4096) {
+            par_each(ThreadPool::shared(), std::forward<Body>(body), grain);
+        }
+
+        std::size_t size() {
+            std::size_t count = 0;
+            each_chunk([&count](std::span<Component>... columns) {
+                count += std::get<0>(std::forward_as_tuple(columns...)).size();
+            });
+            return count;
+        }
+    };
+
+
+    // 👨‍🔬
+    void test_archetypes() {
+        auto store = Store<Archetype<Physics, Health>, Archetype<Physics>>{};
+
+        store.add(Entity{
+            Physics{vec2{0, 0}, vec2{10, 10}},
+            Health{100, 100},
+        });
+        store.archetype<Physics, Health>().add_many(3,
+            Physics{vec2{1, 1}, vec2{1, 0}},
+            Health{100, 0});
+        store.add(Physics{vec2{5, 5}, vec2{0, -1}});
+
+        // Integration only streams the Physics columns
+        store.view<Physics>().par_each([](Physics& body) {
+            body.position += body.velocity;
+        });
+        store.view<Physics, Health>().each([](const Physics& body, Health& health) {
+            if (body.position.x > 5) {
+                health.current -= 10;
+            }
+        });
+
+        auto& living = store.archetype<Physics, Health>();
+        const auto removed = living.remove_if<Health>([](const Health& health) {
+            return health.current <= 0;
+        });
+
+        std::cout << removed << std::endl;
+        std::cout << store.size() << std::endl;
+        std::cout << living.get<Physics>(0).position.x << std::endl;
+    }
+}
@@ -0,0 +1,408 @@
+/**
+    Microbenchmarks for the entity and render paths
+**/
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "entity.hpp"
+#include "archetype.hpp"
+#include "simd.hpp"
+#include "systems.hpp"
+#include "line_framer.hpp"
+#include "change_tracker.hpp"
+#include "world_stream.hpp"
+#include "vertex_array_cache.hpp"
+
+namespace bench {
+
+    /**
+     * 📌 A chunked world's record, what the editor streams in around its focus
+     */
+    struct Marker {
+        float x, y;
+        std::uint32_t kind;
+    };
+}
+
+template<>
+struct hyp::hyper::Schema<bench::Marker> {
+    static constexpr const char* type_name = "bench::Marker";
+    static constexpr std::array fields {
+        HYPER_FIELD(bench::Marker, x),
+        HYPER_FIELD(bench::Marker, y),
+        HYPER_FIELD(bench::Marker, kind),
+    };
+};
+
+namespace bench {
+
+    using namespace hyp;
+    using namespace glm;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * 🕳 Make the optimizer assume `value` is read, so the work producing it stays
+     */
+    template<typename T>
+    void keep(T&& value) {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+
+    /**
+     * ⏱ Best of `runs` timings of body(), in nanoseconds per item
+     */
+    template<typename Body>
+    double measure(std::size_t items, Body&& body, int runs = 5) {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            const auto start = Clock::now();
+            body();
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            best = std::min(best, elapsed.count() / (double)items);
+        }
+        return best;
+    }
+
+    void report(const std::string& name, double ns_per_item) {
+        std::cout << name << ": " << ns_per_item << " ns/item" << std::endl;
+    }
+
+    void report_throughput(const std::string& name, double ns_per_byte) {
+        std::cout << name << ": " << 1.0 / ns_per_byte << " GB/s" << std::endl;
+    }
+
+    struct Transform {
+        mat4 matrix;
+    };
+
+    struct VertexBlock {
+        std::array<vec4, 64> vertices;
+    };
+
+    /**
+     * 📋 Copying get()/set() against get_ref()/modify() on big components
+     */
+    void entity_access() {
+        constexpr std::size_t count = 10000;
+        std::vector<Entity<Transform, VertexBlock, Health>> entities;
+        entities.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            entities.emplace_back(Transform{mat4{1.0f}}, VertexBlock{}, Health{100, 100});
+        }
+
+        report("entity get/set copy (VertexBlock)", measure(count, [&] {
+            for (auto& entity : entities) {
+                auto block = entity.get<VertexBlock>();
+                block.vertices[0].x += 1.0f;
+                entity.set(block);
+            }
+            keep(entities);
+        }));
+
+        report("entity modify in place (VertexBlock)", measure(count, [&] {
+            for (auto& entity : entities) {
+                entity.modify<VertexBlock>([](VertexBlock& block) {
+                    block.vertices[0].x += 1.0f;
+                });
+            }
+            keep(entities);
+        }));
+
+        report("entity get_many/set_many copy (Transform, Health)", measure(count, [&] {
+            for (auto& entity : entities) {
+                auto transform = entity.get<Transform>();
+                auto health = entity.get<Health>();
+                transform.matrix[3].x += 1.0f;
+                health.current -= 1;
+                entity.set_many(transform, health);
+            }
+            keep(entities);
+        }));
+
+        report("entity get_many refs (Transform, Health)", measure(count, [&] {
+            for (auto& entity : entities) {
+                auto [transform, health] = entity.get_many<Transform, Health>();
+                transform.matrix[3].x += 1.0f;
+                health.current -= 1;
+            }
+            keep(entities);
+        }));
+    }
+
+    /**
+     * 🏃 Per-Entity get/set integration against the SIMD kernels over columns
+     */
+    void physics_integration(std::size_t count) {
+        const float dt = 1.0f / 60.0f;
+        const auto suffix = " x" + std::to_string(count);
+        const auto physics = Physics{vec2{0, 0}, vec2{1, 2}};
+        const auto health = Health{100, 150};
+
+        std::vector<Entity<Physics, Health>> entities(count, Entity{physics, health});
+        report("integrate naive Entity" + suffix, measure(count, [&] {
+            for (auto& entity : entities) {
+                auto body = entity.get<Physics>();
+                body.position += body.velocity * dt;
+                entity.set(body);
+            }
+            keep(entities);
+        }));
+
+        auto archetype = Archetype<Physics, Health>{};
+        archetype.add_many(count, physics, health);
+        std::vector<float> position_x(count, 0), position_y(count, 0), velocity_x(count, 1), velocity_y(count, 2);
+
+        for (const auto level : {simd::Level::scalar, simd::Level::sse2, simd::Level::avx2}) {
+            if (level > simd::detect()) {
+                continue;
+            }
+            const auto name = std::string{simd::to_string(level)} + suffix;
+            report("integrate Physics column " + name, measure(count, [&] {
+                simd::integrate(archetype.column<Physics>(), dt, level);
+                keep(archetype);
+            }));
+            report("integrate SoA x/y " + name, measure(count, [&] {
+                simd::integrate(position_x, position_y, velocity_x, velocity_y, dt, level);
+                keep(position_x);
+                keep(position_y);
+            }));
+            report("clamp Health column " + name, measure(count, [&] {
+                simd::clamp_health(archetype.column<Health>(), level);
+                keep(archetype);
+            }));
+        }
+
+        report("clamp Health naive Entity" + suffix, measure(count, [&] {
+            for (auto& entity : entities) {
+                auto current = entity.get<Health>();
+                current.current = std::min(current.current, current.max);
+                entity.set(current);
+            }
+            keep(entities);
+        }));
+
+        auto store = Store<Archetype<Physics, Health>>{};
+        store.archetype<Physics, Health>().add_many(count, physics, Health{100, 0});
+        report("remove dead" + suffix, measure(count, [&] {
+            update_health(store);
+        }, 1));
+    }
+
+    /**
+     * 📣 Marking a fraction of rows from the pool, then one publish, per entity changed
+     */
+    void change_tracking(std::size_t count) {
+        const auto suffix = " x" + std::to_string(count);
+        auto store = Store<Archetype<Physics, Health>>{};
+        auto& archetype = store.archetype<Physics, Health>();
+        archetype.add_many(count, Physics{vec2{0, 0}, vec2{1, 2}}, Health{100, 100});
+        auto changes = ChangeTracker<Archetype<Physics, Health>>{archetype};
+        changes.publish();
+        std::size_t seen = 0;
+        changes.subscribe<Physics>([&seen](std::span<const std::size_t> rows, std::span<const Physics> column) {
+            for (const std::size_t row : rows) {
+                seen += column[row].position.x > 0;
+            }
+        });
+
+        for (const std::size_t every : {1, 16}) {
+            const Physics* first = archetype.column<Physics>().data();
+            report("mark every " + std::to_string(every) + " + publish" + suffix, measure(count / every, [&] {
+                store.view<Physics>().par_each([&changes, first, every](Physics& body) {
+                    if (std::size_t(&body - first) % every == 0) {
+                        changes.mark(body);
+                    }
+                });
+                changes.publish();
+                keep(seen);
+            }));
+        }
+    }
+
+    /**
+     * 🧩 ChunkStream following a focus across a chunked world, per chunk loaded.
+     * Every step waits until the chunk under the focus is resident, like a camera that can't outrun the loader.
+     * Then one chunk of the file is corrupted and the stream has to refuse it.
+     */
+    void chunk_streaming() {
+        constexpr float world_size = 4096.0f;
+        constexpr float chunk_size = 64.0f;
+        const auto path = (std::filesystem::temp_directory_path() / "hyper_bench_chunks.hyper").string();
+
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<float> coordinate(0.0f, world_size);
+        std::vector<Marker> markers(1000000);
+        for (std::size_t i = 0; i < markers.size(); ++i) {
+            markers[i] = {coordinate(gen), coordinate(gen), std::uint32_t(i % 8)};
+        }
+        if (!hyper::write_chunked(path, std::span<const Marker>{markers}, chunk_size)) {
+            return;
+        }
+
+        const auto wait_for = [](auto&& ready) {
+            const auto deadline = Clock::now() + std::chrono::seconds{5};
+            while (!ready() && Clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+            }
+            return ready();
+        };
+
+        {
+            hyper::ChunkStream<Marker> stream{path, {256.0f, std::size_t{4} << 20}};
+            constexpr std::size_t steps = 256;
+            std::size_t seen = 0;
+            const auto start = Clock::now();
+            for (std::size_t step = 0; step < steps; ++step) {
+                const float along = (float(step) + 0.5f) * world_size / float(steps);
+                stream.focus(along, along);
+                const auto cell = hyper::cell_of(Marker{along, along, 0}, chunk_size);
+                wait_for([&] {
+                    const auto chunk = stream.chunk(cell);
+                    seen += chunk ? chunk->records.size() : 0;
+                    return chunk != nullptr;
+                });
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            keep(seen);
+
+            const auto stats = stream.stats();
+            report("stream chunks along the diagonal", elapsed.count() / double(std::max<std::uint64_t>(stats.loads, 1)));
+            std::cout << "  " << stats.loads << " loads, " << stats.evictions << " evictions, "
+                      << stats.hits << " hits, " << stats.misses << " misses, "
+                      << stats.resident_chunks << " resident (" << stats.resident_bytes << " bytes), "
+                      << stats.load_ms_average << " ms average load, " << stats.load_ms_max << " ms max" << std::endl;
+        }
+
+        // Flip a byte in the first chunk's records, the stream must notice and never make it resident
+        hyper::Cell damaged;
+        std::uint64_t records_offset;
+        {
+            const hyper::File file{path};
+            const auto& first = file.table<hyper::ChunkDescriptor>("chunks")[0];
+            damaged = {first.cell_x, first.cell_y};
+            records_offset = file.find("records")->offset;
+        }
+        {
+            std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+            file.seekg(std::streamoff(records_offset));
+            const auto byte = char(file.get() ^ 0x5a);
+            file.seekp(std::streamoff(records_offset));
+            file.put(byte);
+        }
+        hyper::ChunkStream<Marker> stream{path, {256.0f, std::size_t{4} << 20}};
+        stream.focus((float(damaged.x) + 0.5f) * chunk_size, (float(damaged.y) + 0.5f) * chunk_size);
+        const bool refused = wait_for([&] { return stream.stats().rejected > 0; }) && !stream.chunk(damaged);
+        std::cout << "  corrupted chunk " << (refused ? "refused" : "NOT refused") << std::endl;
+        std::filesystem::remove(path);
+    }
+
+    /**
+     * 📡 reactive_tester's input: runs of one letter, 4 to 18 long, each closed by '\r'
+     */
+    std::vector<std::uint8_t> line_stream(std::size_t size) {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<> length(4, 18);
+        std::vector<std::uint8_t> stream;
+        stream.reserve(size + 19);
+        for (int line = 0; stream.size() < size; ++line) {
+            stream.insert(stream.end(), std::size_t(length(gen)), std::uint8_t('A' + line % 26));
+            stream.push_back('\r');
+        }
+        return stream;
+    }
+
+    /**
+     * 🐌 What the Rx pipeline does per packet, minus the observable plumbing: the accumulator
+     * copied for every byte, a regex built and run per packet, lines summed string by string
+     */
+    std::size_t frame_like_rx(std::span<const std::uint8_t> stream, std::size_t packet_size) {
+        std::size_t lines = 0;
+        std::string line;
+        for (std::size_t first = 0; first < stream.size(); first += packet_size) {
+            const auto packet = stream.subspan(first, std::min(packet_size, stream.size() - first));
+            std::vector<std::uint8_t> bytes;
+            for (const std::uint8_t byte : packet) {
+                std::vector<std::uint8_t> next = bytes;
+                next.push_back(byte);
+                bytes = std::move(next);
+            }
+            std::string text(bytes.begin(), bytes.end());
+            std::regex delimiter(R"/(\r)/");
+            std::cregex_token_iterator cursor(text.data(), text.data() + text.size(), delimiter, {-1, 0});
+            std::vector<std::string> splits(cursor, std::cregex_token_iterator{});
+            for (auto& split : splits) {
+                if (split.empty()) {
+                    continue;
+                }
+                line = line + split;
+                if (split.back() == '\r') {
+                    line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+                    keep(line);
+                    line.clear();
+                    ++lines;
+                }
+            }
+        }
+        return lines;
+    }
+
+    /**
+     * ✂ LineFramer against the Rx-style pipeline, over small packets like reactive_tester's and big ones
+     */
+    void line_framing() {
+        const auto stream = line_stream(std::size_t(1) << 24);
+        const auto small = std::span<const std::uint8_t>{stream}.first(std::size_t(1) << 18);
+
+        for (const std::size_t packet_size : {17, 4096}) {
+            const auto suffix = " packets of " + std::to_string(packet_size);
+            report_throughput("frame lines Rx-style regex" + suffix, measure(small.size(), [&] {
+                keep(frame_like_rx(small, packet_size));
+            }, 1));
+
+            LineFramer framer{'\r', 256};
+            std::size_t lines = 0;
+            report_throughput("frame lines LineFramer" + suffix, measure(stream.size(), [&] {
+                for (std::size_t first = 0; first < stream.size(); first += packet_size) {
+                    framer.push(std::span{stream}.subspan(first, std::min(packet_size, stream.size() - first)),
+                                [&lines](std::string_view line) {
+                        lines += !line.empty();
+                    });
+                }
+                keep(lines);
+            }));
+        }
+    }
+}
+
+int main() {
+    hyp::gl::test_vertex_array_cache();
+    bench::entity_access();
+    for (const std::size_t count : {10000, 100000, 1000000}) {
+        bench::physics_integration(count);
+        bench::change_tracking(count);
+    }
+    bench::line_framing();
+    bench::chunk_streaming();
+    return 0;
+}
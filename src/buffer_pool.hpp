@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "gl_state.hpp"
+#include "vertex_array_cache.hpp"
+
+namespace hyp::gl {
+
+    struct BufferCounters {
+        std::size_t bytes_uploaded = 0;
+        std::size_t uploads = 0;
+        std::size_t skipped_uploads = 0;
+        std::size_t buffers_created = 0;
+    };
+
+    /**
+     * 📊 Buffer traffic, `frame` is reset by begin_frame(), `buffers_live` never is
+     */
+    struct BufferStats {
+        BufferCounters frame;
+        BufferCounters total;
+        std::size_t buffers_live = 0;
+
+        void begin_frame() {
+            frame = {};
+        }
+    };
+
+    inline BufferStats buffer_stats;
+
+    /**
+     * 📦 One persistent vertex buffer plus a CPU copy of what it holds.
+     * upload() diffs against the copy and only sends the dirty byte range, so an attribute
+     * re-bound with the same data every frame costs a memcmp and no driver traffic.
+     * Growing re-allocates; rewriting most of the buffer orphans it first so the driver
+     * doesn't stall on a frame still reading the old contents.
+     */
+    class AttributeBuffer {
+    public:
+        AttributeBuffer() = default;
+
+        AttributeBuffer(const AttributeBuffer&) = delete;
+        AttributeBuffer& operator=(const AttributeBuffer&) = delete;
+
+        AttributeBuffer(AttributeBuffer&& other) noexcept :
+            buffer{std::exchange(other.buffer, 0)},
+            buffer_serial{std::exchange(other.buffer_serial, 0)},
+            capacity{std::exchange(other.capacity, 0)},
+            usage{other.usage},
+            shadow{std::move(other.shadow)} {
+        }
+
+        AttributeBuffer& operator=(AttributeBuffer&& other) noexcept {
+            std::swap(buffer, other.buffer);
+            std::swap(buffer_serial, other.buffer_serial);
+            std::swap(capacity, other.capacity);
+            std::swap(usage, other.usage);
+            std::swap(shadow, other.shadow);
+            return *this;
+        }
+
+        ~AttributeBuffer() {
+            if (buffer) {
+                VertexArrayCache::forget_buffer(buffer_serial);
+                state.forget_buffer(buffer);
+                glDeleteBuffers(1, &buffer);
+                --buffer_stats.buffers_live;
+            }
+        }
+
+        GLuint id() const {
+            return buffer;
+        }
+
+        /**
+         * Unique for the life of the program, unlike the GL name which gets recycled
+         */
+        std::uint64_t serial() const {
+            return buffer_serial;
+        }
+
+        std::size_t size() const {
+            return shadow.size();
+        }
+
+        /**
+         * ⬆ Make the buffer hold `bytes`, leaves it bound to GL_ARRAY_BUFFER
+         */
+        void upload(std::span<const std::byte> bytes) {
+            if (!buffer) {
+                glGenBuffers(1, &buffer);
+                buffer_serial = ++serials;
+                ++buffer_stats.buffers_live;
+                count(&BufferCounters::buffers_created, 1);
+            }
+            state.bind_buffer(GL_ARRAY_BUFFER, buffer);
+
+            if (bytes.size() > capacity) {
+                glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(bytes.size()), bytes.data(), usage);
+                capacity = bytes.size();
+                shadow.assign(bytes.begin(), bytes.end());
+                count(&BufferCounters::bytes_uploaded, bytes.size());
+                count(&BufferCounters::uploads, 1);
+                return;
+            }
+
+            std::size_t first = 0;
+            std::size_t last = bytes.size();
+            if (bytes.size() == shadow.size()) {
+                const auto [left, right] = std::mismatch(bytes.begin(), bytes.end(), shadow.begin());
+                if (left == bytes.end()) {
+                    count(&BufferCounters::skipped_uploads, 1);
+                    return;
+                }
+                first = std::size_t(left - bytes.begin());
+                while (last > first && bytes[last - 1] == shadow[last - 1]) {
+                    --last;
+                }
+            }
+
+            if ((last - first) * 2 > capacity) {
+                glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity), nullptr, usage);
+                first = 0;
+                last = bytes.size();
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, GLintptr(first), GLsizeiptr(last - first), bytes.data() + first);
+            if (bytes.size() == shadow.size()) {
+                std::copy(bytes.begin() + first, bytes.begin() + last, shadow.begin() + first);
+            } else {
+                shadow.assign(bytes.begin(), bytes.end());
+            }
+            count(&BufferCounters::bytes_uploaded, last - first);
+            count(&BufferCounters::uploads, 1);
+        }
+
+    private:
+        static inline std::uint64_t serials = 0;
+
+        GLuint buffer = 0;
+        std::uint64_t buffer_serial = 0;
+        std::size_t capacity = 0;
+        GLenum usage = GL_DYNAMIC_DRAW;
+        std::vector<std::byte> shadow;
+
+        static void count(std::size_t BufferCounters::* counter, std::size_t amount) {
+            buffer_stats.frame.*counter += amount;
+            buffer_stats.total.*counter += amount;
+        }
+    };
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "archetype.hpp"
+#include "frame_arena.hpp"
+
+namespace hyp {
+
+    /**
+     * 🚩 One bit per row, set from any number of threads without locks.
+     * resize() and move_row() are structural and must not overlap with mark().
+     */
+    class DirtyBits {
+    public:
+        std::size_t size() const {
+            return rows;
+        }
+
+        /**
+         * Rows past the new size are forgotten, new rows start clean
+         */
+        void resize(std::size_t row_count) {
+            const std::size_t needed = (row_count + 63) / 64;
+            if (needed > word_count) {
+                auto grown = std::make_unique<std::atomic<std::uint64_t>[]>(std::max(needed, word_count * 2));
+                for (std::size_t word = 0; word < word_count; ++word) {
+                    grown[word].store(words[word].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                words = std::move(grown);
+                word_count = std::max(needed, word_count * 2);
+            }
+            for (std::size_t row = row_count; row < rows && row % 64 != 0; ++row) {
+                clear(row);
+            }
+            for (std::size_t word = needed; word < (rows + 63) / 64; ++word) {
+                words[word].store(0, std::memory_order_relaxed);
+            }
+            rows = row_count;
+        }
+
+        /**
+         * 🚩 Safe from any thread. Reads first, so rows already marked this frame cost no atomic write.
+         */
+        void mark(std::size_t row) {
+            assert(row < rows);
+            auto& word = words[row / 64];
+            const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+            if (!(word.load(std::memory_order_relaxed) & bit)) {
+                word.fetch_or(bit, std::memory_order_relaxed);
+            }
+        }
+
+        bool marked(std::size_t row) const {
+            return words[row / 64].load(std::memory_order_relaxed) & (std::uint64_t(1) << (row % 64));
+        }
+
+        void clear(std::size_t row) {
+            words[row / 64].fetch_and(~(std::uint64_t(1) << (row % 64)), std::memory_order_relaxed);
+        }
+
+        /**
+         * Swap-and-pop for the bits: `from` (the last row) takes over `to`
+         */
+        void move_row(std::size_t from, std::size_t to) {
+            if (from != to) {
+                marked(from) ? mark(to) : clear(to);
+            }
+            clear(from);
+        }
+
+        /**
+         * 🧺 Append every marked row to `out` in ascending order and clear them.
+         * A mark racing with the drain lands either in this batch or the next, never in neither.
+         */
+        template<typename Rows>
+        void drain(Rows& out) {
+            const std::size_t used = (rows + 63) / 64;
+            for (std::size_t word = 0; word < used; ++word) {
+                if (!words[word].load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                for (std::uint64_t bits = words[word].exchange(0, std::memory_order_acquire); bits; bits &= bits - 1) {
+                    out.push_back(word * 64 + std::size_t(std::countr_zero(bits)));
+                }
+            }
+        }
+
+    private:
+        std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+        std::size_t word_count = 0;
+        std::size_t rows = 0;
+    };
+
+    template<typename ArchetypeType>
+    class ChangeTracker;
+
+    /**
+     * 📣 Batched change notifications for one archetype, one DirtyBits per component.
+     * Systems mark what they wrote, from any worker thread. publish() then runs once per frame,
+     * after the workers are joined: every subscriber of a component gets a single call with all
+     * changed rows, ascending and without duplicates, plus the column to read them from.
+     * Structural changes have to go through the tracker so the bits follow swap-and-pop and new rows
+     * get reported; rows added or removed on the archetype directly trip an assert on the next use.
+     * It mirrors the archetype's structural interface, so code like hyper::apply_chunks can be
+     * handed the tracker instead and have its writes reported.
+     */
+    template<typename... T>
+    class ChangeTracker<Archetype<T...>> {
+    public:
+        using Components = typename Archetype<T...>::Components;
+
+        template<typename Component>
+        using Subscriber = std::function<void(std::span<const std::size_t> rows, std::span<const Component> column)>;
+
+        explicit ChangeTracker(Archetype<T...>& archetype) :
+            archetype{archetype} {
+            resize_bits();
+        }
+
+        std::size_t size() const {
+            return archetype.size();
+        }
+
+        /**
+         * The archetype's column, whoever writes through it still has to mark()
+         */
+        template<typename Component>
+        std::span<Component> column() {
+            return archetype.template column<Component>();
+        }
+
+        template<typename Component>
+        void mark(std::size_t row) {
+            check_rows();
+            bits<Component>().mark(row);
+        }
+
+        /**
+         * 🚩 Mark by reference, for par_each bodies that only see the component
+         */
+        template<typename Component>
+        void mark(const Component& component) {
+            check_rows();
+            const auto column = archetype.template column<Component>();
+            assert(&component >= column.data() && &component < column.data() + column.size());
+            bits<Component>().mark(std::size_t(&component - column.data()));
+        }
+
+        template<typename Component>
+        void mark_all() {
+            check_rows();
+            for (std::size_t row = 0; row < archetype.size(); ++row) {
+                bits<Component>().mark(row);
+            }
+        }
+
+        template<typename Component>
+        bool marked(std::size_t row) const {
+            check_rows();
+            return std::get<tuple_element_index_v<Component, std::tuple<T...>>>(dirty).marked(row);
+        }
+
+        /**
+         * ➕ Add a row and mark all its components, a new entity is a change for every subscriber
+         */
+        std::size_t add(T... components) {
+            check_rows();
+            const std::size_t row = archetype.add(std::move(components)...);
+            resize_bits();
+            (bits<T>().mark(row), ...);
+            return row;
+        }
+
+        /**
+         * ➕ Append `count` copies of the same row, all marked
+         */
+        std::size_t add_many(std::size_t count, const T&... components) {
+            check_rows();
+            return mark_added(archetype.add_many(count, components...));
+        }
+
+        /**
+         * ➕ Append one row per element of the columns, all marked
+         */
+        std::size_t add_many(std::span<const T>... components) {
+            check_rows();
+            return mark_added(archetype.add_many(components...));
+        }
+
+        /**
+         * ➖ Swap-and-pop the row, its pending changes go with it and the last row's move in
+         */
+        void remove(std::size_t row) {
+            check_rows();
+            const std::size_t last = archetype.size() - 1;
+            archetype.remove(row);
+            (bits<T>().move_row(last, row), ...);
+            resize_bits();
+        }
+
+        /**
+         * ➖ Archetype::remove_many through the tracker, `rows` sorted ascending without duplicates
+         */
+        void remove_many(std::span<const std::size_t> rows) {
+            for (auto row = rows.rbegin(); row != rows.rend(); ++row) {
+                remove(*row);
+            }
+        }
+
+        /**
+         * ➖ Archetype::remove_if through the tracker, returns how many went
+         */
+        template<typename... Component, typename Predicate>
+        std::size_t remove_if(Predicate predicate) {
+            const std::size_t before = archetype.size();
+            std::size_t row = 0;
+            while (row < archetype.size()) {
+                if (predicate(archetype.template column<Component>()[row]...)) {
+                    remove(row);
+                } else {
+                    ++row;
+                }
+            }
+            return before - archetype.size();
+        }
+
+        template<typename Component, typename Callback>
+        void subscribe(Callback&& callback) {
+            subscribers<Component>().emplace_back(std::forward<Callback>(callback));
+        }
+
+        /**
+         * 📤 Drain every component's bits and hand each batch to its subscribers.
+         * Returns the number of changed rows, summed over components.
+         */
+        std::size_t publish() {
+            check_rows();
+            std::size_t changed = 0;
+            ([&] {
+                std::pmr::vector<std::size_t> rows{&arena};
+                bits<T>().drain(rows);
+                changed += rows.size();
+                if (rows.empty()) {
+                    return;
+                }
+                const auto column = std::span<const T>{archetype.template column<T>()};
+                for (const auto& subscriber : subscribers<T>()) {
+                    subscriber(rows, column);
+                }
+            }(), ...);
+            arena.reset();
+            return changed;
+        }
+
+    private:
+        template<typename>
+        using BitsFor = DirtyBits;
+
+        Archetype<T...>& archetype;
+        std::tuple<BitsFor<T>...> dirty;
+        std::tuple<std::vector<Subscriber<T>>...> subscriber_lists;
+        // Changed-row batches only live through publish(), so steady-state frames don't allocate
+        FrameArena arena;
+
+        void resize_bits() {
+            (bits<T>().resize(archetype.size()), ...);
+        }
+
+        void check_rows() const {
+            assert(std::get<0>(dirty).size() == archetype.size() &&
+                   "rows were added or removed on the archetype, not through its ChangeTracker");
+        }
+
+        std::size_t mark_added(std::size_t first) {
+            resize_bits();
+            for (std::size_t row = first; row < archetype.size(); ++row) {
+                (bits<T>().mark(row), ...);
+            }
+            return first;
+        }
+
+        template<typename Component>
+        DirtyBits& bits() {
+            return std::get<tuple_element_index_v<Component, std::tuple<T...>>>(dirty);
+        }
+
+        template<typename Component>
+        std::vector<Subscriber<Component>>& subscribers() {
+            return std::get<tuple_element_index_v<Component, std::tuple<T...>>>(subscriber_lists);
+        }
+    };
+
+
+    // 👨‍🔬
+    void test_change_tracker() {
+        auto store = Store<Archetype<Physics, Health>>{};
+        auto& archetype = store.archetype<Physics, Health>();
+        archetype.add_many(10000, Physics{vec2{0, 0}, vec2{1, 0}}, Health{100, 100});
+
+        auto changes = ChangeTracker<Archetype<Physics, Health>>{archetype};
+        changes.publish();
+        std::size_t moved = 0;
+        changes.subscribe<Physics>([&moved](std::span<const std::size_t> rows, std::span<const Physics>) {
+            moved += rows.size();
+        });
+
+        // Only every third entity moves, workers mark as they write
+        const Physics* first = archetype.column<Physics>().data();
+        store.view<Physics>().par_each([&changes, first](Physics& body) {
+            if ((&body - first) % 3 == 0) {
+                body.position += body.velocity;
+                changes.mark(body);
+            }
+        });
+        const std::size_t changed = changes.publish();
+        std::cout << changed << " " << moved << std::endl;
+        assert(changed == 3334 && moved == 3334);
+
+        // Structural changes through the tracker: new rows are reported, removed ones take their bits along
+        changes.add_many(2, Physics{vec2{0, 0}, vec2{0, 0}}, Health{100, 100});
+        changes.mark<Physics>(0);
+        changes.remove(0);
+        assert(changes.marked<Physics>(0) && !changes.marked<Physics>(1));
+        moved = 0;
+        [[maybe_unused]] const std::size_t structural = changes.publish();
+        assert(structural == 2 * 2 && moved == 2);
+    }
+}
@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <iostream>
 #include <vector>
 #include <sstream>
@@ -6,6 +7,7 @@
 #include <GLFW/glfw3.h>
 
 #include "world.hyper"
+#include "world_stream.hpp"
 #include "entity.hpp"
 
 using namespace std;
@@ -167,6 +169,21 @@ int main()
 {
 	hyp::test();
 
+	// Seed the binary save from the compiled-in world the first time only, later runs keep their edits
+	if (!filesystem::exists(World::save_path))
+	{
+		hyp::hyper::Writer{}.table("structures", World::data).write(World::save_path);
+	}
+	const auto world_file = hyp::hyper::File{ World::save_path };
+	const auto structures = world_file.table<World::Structure>("structures");
+	cout << structures.size() << " structures saved" << endl;
+	// The chunked copy is only a streaming cache of the save, rebuilt whenever the save is newer
+	if (!filesystem::exists(World::chunked_save_path) ||
+		filesystem::last_write_time(World::chunked_save_path) < filesystem::last_write_time(World::save_path))
+	{
+		hyp::hyper::write_chunked(World::chunked_save_path, structures, 64.0f);
+	}
+
 	cout << "Hello Worldlings!" << endl;
 	const auto thingie { tuple_cat(make_tuple(1), make_tuple(2)) };
 	const auto thinger = tuple_cat(make_tuple(0), thingie);
@@ -240,6 +257,11 @@ int main()
 		}
 	};
 
+	// 🧩 Page in the chunks around the cursor, the editor's focus, one world unit per pixel
+	auto world_chunks = hyp::hyper::ChunkStream<World::Structure>{ World::chunked_save_path, { 512.0f, size_t{ 16 } << 20 } };
+	auto hovered = hyp::hyper::Cell{ 0, 0 };
+	string hovered_title;
+
 	while (!glfwWindowShouldClose(window))
 	{
 		float ratio;
@@ -249,6 +271,30 @@ int main()
 		glfwGetFramebufferSize(window, &width, &height);
 		ratio = (float)width / (float)height;
 
+		if (world_chunks)
+		{
+			double cursor_x, cursor_y;
+			glfwGetCursorPos(window, &cursor_x, &cursor_y);
+			const World::Structure focus{ float(cursor_x) - width / 2.0f, height / 2.0f - float(cursor_y) };
+			const auto cell = hyp::hyper::cell_of(focus, world_chunks.chunk_size());
+			if (cell != hovered)
+			{
+				hovered = cell;
+				world_chunks.focus(focus.x, focus.y);
+			}
+			// Until the chunk is resident the title keeps showing the last one
+			if (const auto chunk = world_chunks.chunk(cell))
+			{
+				auto title = "HyperChill - chunk " + to_string(cell.x) + ", " + to_string(cell.y) + ": "
+					+ to_string(chunk->records.size()) + " structures";
+				if (title != hovered_title)
+				{
+					hovered_title = move(title);
+					glfwSetWindowTitle(window, hovered_title.c_str());
+				}
+			}
+		}
+
 		glViewport(0, 0, width, height);
 		glClear(GL_COLOR_BUFFER_BIT);
 
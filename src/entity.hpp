@@ -1,3 +1,5 @@
+#pragma once
+
 #include <tuple>
 #include <iostream>
 #include <glm/vec2.hpp>
@@ -48,30 +50,51 @@ namespace hyp {
     private:
     public:
         std::tuple<T...> components;
-        explicit Entity(T... args) : components{args...} {}
+        explicit Entity(T... args) : components{std::move(args)...} {}
+
+        template<typename Component>
+        Component get() const {
+            return get_ref<Component>();
+        }
+
+        /**
+         * 🔗 Reference straight into the tuple, no copy
+         */
+        template<typename Component>
+        Component& get_ref() {
+            constexpr std::size_t index =
+                    tuple_element_index_v<Component, std::tuple<T...>>;
+            return std::get<index>(components);
+        }
 
         template<typename Component>
-        Component get() {
+        const Component& get_ref() const {
             constexpr std::size_t index =
                     tuple_element_index_v<Component, std::tuple<T...>>;
             return std::get<index>(components);
         }
 
         template<typename... Component>
-        std::tuple<Component...> get_many() {
-            return std::make_tuple(get<Component>()...);
+        std::tuple<Component&...> get_many() {
+            return std::tie(get_ref<Component>()...);
+        }
+
+        /**
+         * ✏ Read-modify-write in place: modifier(Component&)
+         */
+        template<typename Component, typename Modifier>
+        void modify(Modifier&& modifier) {
+            modifier(get_ref<Component>());
         }
 
         template<typename Component>
-        void set(Component component) {
-            constexpr std::size_t index =
-                    tuple_element_index_v<Component, std::tuple<T...>>;
-            std::get<index>(components) = component;
+        void set(Component&& component) {
+            get_ref<std::remove_cvref_t<Component>>() = std::forward<Component>(component);
         }
 
         template<typename... Component>
-        void set_many(Component... component) {
-            (set<Component>(component), ...);
+        void set_many(Component&&... component) {
+            (set(std::forward<Component>(component)), ...);
         }
     };
 
@@ -92,8 +115,8 @@ namespace hyp {
     };
 
     template<typename... T>
-    auto get_position_x(Entity<T...> entity) {
-        const auto thing = entity.get<Physics>();
+    auto get_position_x(const Entity<T...>& entity) {
+        const auto& thing = entity.template get_ref<Physics>();
         return thing.position.x;
     }
 
@@ -106,6 +129,9 @@ namespace hyp {
         auto physics = entity.get<Physics>();
         physics.velocity = vec2{ 32, 32 };
         entity.set(physics);
+        entity.modify<Physics>([](Physics& physics) {
+            physics.position += physics.velocity;
+        });
 
         const auto x = get_position_x(entity);
         std::cout << x << std::endl;
@@ -113,7 +139,6 @@ namespace hyp {
         {
             auto [physics, health] = entity.get_many<Physics, Health>();
             health.current -= 10;
-            entity.set_many(physics, health);
             auto[physics2, health2] = entity.get_many<Physics, Health>();
             std::cout << physics2.position.x << std::endl;
             std::cout << physics2.velocity.x << std::endl;
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace hyp {
+
+    /**
+     * 👀 Reports which of a fixed set of files changed since the last poll().
+     * On Linux this is inotify on the files' directories - editors tend to save by writing
+     * a temp file and renaming it over the original, which a watch on the file itself misses.
+     * Elsewhere it falls back to comparing modification times on each poll.
+     */
+    class FileWatcher {
+    public:
+        explicit FileWatcher(std::vector<std::filesystem::path> watched) :
+            files{std::move(watched)} {
+            for (auto& file : files) {
+                std::error_code error;
+                const auto absolute = std::filesystem::absolute(file, error);
+                file = error ? file.lexically_normal() : absolute.lexically_normal();
+            }
+#if defined(__linux__)
+            descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            for (const auto& file : files) {
+                const auto directory = file.parent_path();
+                const int watch = inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+                if (watch >= 0) {
+                    directories[watch] = directory;
+                }
+            }
+#else
+            for (const auto& file : files) {
+                std::error_code error;
+                stamps.push_back(std::filesystem::last_write_time(file, error));
+            }
+#endif
+        }
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        ~FileWatcher() {
+#if defined(__linux__)
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+#endif
+        }
+
+        /**
+         * 🔔 Files touched since the last call, each listed once. Never blocks.
+         */
+        std::span<const std::filesystem::path> poll() {
+            changed.clear();
+#if defined(__linux__)
+            alignas(inotify_event) char buffer[4096];
+            while (true) {
+                const ssize_t length = read(descriptor, buffer, sizeof(buffer));
+                if (length <= 0) {
+                    break;
+                }
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += ssize_t(sizeof(inotify_event) + event->len);
+                    const auto directory = directories.find(event->wd);
+                    if (event->len == 0 || directory == directories.end()) {
+                        continue;
+                    }
+                    mark(directory->second / event->name);
+                }
+            }
+#else
+            for (std::size_t i = 0; i < files.size(); ++i) {
+                std::error_code error;
+                const auto stamp = std::filesystem::last_write_time(files[i], error);
+                if (!error && stamp != stamps[i]) {
+                    stamps[i] = stamp;
+                    mark(files[i]);
+                }
+            }
+#endif
+            return changed;
+        }
+
+    private:
+        std::vector<std::filesystem::path> files;
+        std::vector<std::filesystem::path> changed;
+#if defined(__linux__)
+        int descriptor = -1;
+        std::unordered_map<int, std::filesystem::path> directories;
+#else
+        std::vector<std::filesystem::file_time_type> stamps;
+#endif
+
+        void mark(const std::filesystem::path& path) {
+            for (const auto& file : files) {
+                if (file == path) {
+                    for (const auto& already : changed) {
+                        if (already == file) {
+                            return;
+                        }
+                    }
+                    changed.push_back(file);
+                    return;
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace hyp {
+
+    /**
+     * ⏲ Calls `step` on its own thread at a fixed rate until destroyed.
+     * When a step overruns, the next ones run back to back to catch up. If it falls more than
+     * `max_lag` behind, the backlog is dropped instead of spiralling, so the simulation slows down.
+     */
+    class FixedStepThread {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        FixedStepThread(clock::duration step_length, std::function<void()> step,
+                        clock::duration max_lag = std::chrono::milliseconds{250}) :
+            step_length{step_length},
+            max_lag{max_lag},
+            step{std::move(step)},
+            thread{[this] { run(); }} {
+        }
+
+        FixedStepThread(const FixedStepThread&) = delete;
+        FixedStepThread& operator=(const FixedStepThread&) = delete;
+
+        ~FixedStepThread() {
+            stopping = true;
+            thread.join();
+        }
+
+        std::uint64_t steps() const {
+            return completed.load(std::memory_order_relaxed);
+        }
+
+    private:
+        const clock::duration step_length;
+        const clock::duration max_lag;
+        const std::function<void()> step;
+        std::atomic<bool> stopping{false};
+        std::atomic<std::uint64_t> completed{0};
+        // Last, so everything it reads is initialized before it starts
+        std::thread thread;
+
+        void run() {
+            auto next = clock::now();
+            while (!stopping) {
+                step();
+                completed.fetch_add(1, std::memory_order_relaxed);
+                next += step_length;
+                const auto now = clock::now();
+                if (now - next > max_lag) {
+                    next = now;
+                }
+                std::this_thread::sleep_until(next);
+            }
+        }
+    };
+}
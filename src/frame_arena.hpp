@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace hyp {
+
+    struct ArenaStats {
+        // Served from the arena since the last reset
+        std::size_t allocations = 0;
+        std::size_t bytes = 0;
+        // Times the arena itself had to go to the upstream resource, and how much it took
+        std::size_t upstream_allocations = 0;
+        std::size_t upstream_bytes = 0;
+    };
+
+    /**
+     * 🧻 Bump allocator for data that dies at the end of the frame, as a std::pmr::memory_resource
+     * so pmr containers can sit on it. Deallocation does nothing, reset() takes everything back at once.
+     * When a frame outgrows the block it gets another one from upstream, and the next reset() merges
+     * them into one block big enough for the whole frame, so a steady workload stops touching the heap.
+     * One thread at a time, give every thread its own.
+     */
+    class FrameArena final : public std::pmr::memory_resource {
+    public:
+        explicit FrameArena(std::size_t initial_capacity = 16 * 1024,
+                            std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+            initial_capacity{std::max<std::size_t>(initial_capacity, alignof(std::max_align_t))},
+            upstream{upstream} {
+        }
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        ~FrameArena() override {
+            release();
+        }
+
+        /**
+         * 🔁 Everything handed out since the last reset is gone, no pmr container may still hold it
+         */
+        void reset() {
+            if (blocks.size() > 1) {
+                std::size_t total = 0;
+                for (const auto& block : blocks) {
+                    total += block.size;
+                }
+                release();
+                grow(total);
+            }
+            if (!blocks.empty()) {
+                cursor = blocks.back().memory;
+                end = cursor + blocks.back().size;
+            }
+            counters = {};
+        }
+
+        const ArenaStats& stats() const {
+            return counters;
+        }
+
+        std::size_t capacity() const {
+            std::size_t total = 0;
+            for (const auto& block : blocks) {
+                total += block.size;
+            }
+            return total;
+        }
+
+    private:
+        struct Block {
+            std::byte* memory;
+            std::size_t size;
+        };
+
+        const std::size_t initial_capacity;
+        std::pmr::memory_resource* const upstream;
+        std::vector<Block> blocks;
+        std::byte* cursor = nullptr;
+        std::byte* end = nullptr;
+        ArenaStats counters;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            auto* aligned = align(cursor, alignment);
+            if (!cursor || aligned + bytes > end) {
+                const std::size_t last = blocks.empty() ? initial_capacity / 2 : blocks.back().size;
+                grow(std::max(last * 2, bytes + alignment));
+                aligned = align(cursor, alignment);
+            }
+            cursor = aligned + bytes;
+            ++counters.allocations;
+            counters.bytes += bytes;
+            return aligned;
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        static std::byte* align(std::byte* pointer, std::size_t alignment) {
+            const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+            return pointer + ((alignment - address % alignment) % alignment);
+        }
+
+        void grow(std::size_t size) {
+            auto* memory = static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t)));
+            blocks.push_back({memory, size});
+            cursor = memory;
+            end = memory + size;
+            ++counters.upstream_allocations;
+            counters.upstream_bytes += size;
+        }
+
+        void release() {
+            for (const auto& block : blocks) {
+                upstream->deallocate(block.memory, block.size, alignof(std::max_align_t));
+            }
+            blocks.clear();
+            cursor = nullptr;
+            end = nullptr;
+        }
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace hyp::bench {
+
+    /**
+     * 📸 What one frame cost. cpu_ms covers simulation and command submission,
+     * frame_ms also waits for the GPU to finish so it's the full frame on a software rasterizer.
+     */
+    struct FrameSample {
+        double cpu_ms = 0;
+        double frame_ms = 0;
+        std::size_t draw_calls = 0;
+        std::size_t uploads = 0;
+        std::size_t bytes_uploaded = 0;
+        std::size_t gl_calls = 0;
+        std::size_t redundant_binds = 0;
+        std::size_t location_queries = 0;
+        // Heap allocations and bytes that escaped to global operator new this frame
+        std::size_t allocations = 0;
+        std::size_t heap_bytes = 0;
+        // Transient bytes served from frame arenas instead
+        std::size_t arena_bytes = 0;
+        std::size_t state_calls_eliminated = 0;
+    };
+
+    /**
+     * 📈 Collects FrameSamples and writes the distribution out as JSON
+     */
+    class FrameReport {
+    public:
+        std::string renderer;
+        std::size_t entities = 0;
+
+        void reserve(std::size_t frames) {
+            samples.reserve(frames);
+        }
+
+        void add(const FrameSample& sample) {
+            samples.push_back(sample);
+        }
+
+        std::size_t size() const {
+            return samples.size();
+        }
+
+        void write_json(std::ostream& stream) const {
+            stream << "{\n"
+                   << "  \"renderer\": \"" << escaped(renderer) << "\",\n"
+                   << "  \"entities\": " << entities << ",\n"
+                   << "  \"frames\": " << samples.size() << ",\n";
+            write_distribution(stream, "cpu_ms", &FrameSample::cpu_ms);
+            stream << ",\n";
+            write_distribution(stream, "frame_ms", &FrameSample::frame_ms);
+            stream << ",\n";
+            write_distribution(stream, "draw_calls", &FrameSample::draw_calls);
+            stream << ",\n";
+            write_distribution(stream, "uploads", &FrameSample::uploads);
+            stream << ",\n";
+            write_distribution(stream, "bytes_uploaded", &FrameSample::bytes_uploaded);
+            stream << ",\n";
+            write_distribution(stream, "gl_calls", &FrameSample::gl_calls);
+            stream << ",\n";
+            write_distribution(stream, "redundant_binds", &FrameSample::redundant_binds);
+            stream << ",\n";
+            write_distribution(stream, "location_queries", &FrameSample::location_queries);
+            stream << ",\n";
+            write_distribution(stream, "allocations", &FrameSample::allocations);
+            stream << ",\n";
+            write_distribution(stream, "heap_bytes", &FrameSample::heap_bytes);
+            stream << ",\n";
+            write_distribution(stream, "arena_bytes", &FrameSample::arena_bytes);
+            stream << ",\n";
+            write_distribution(stream, "state_calls_eliminated", &FrameSample::state_calls_eliminated);
+            stream << "\n}" << std::endl;
+        }
+
+    private:
+        std::vector<FrameSample> samples;
+
+        template<typename Value>
+        void write_distribution(std::ostream& stream, const char* name, Value FrameSample::* field) const {
+            std::vector<double> values;
+            values.reserve(samples.size());
+            double sum = 0;
+            for (const auto& sample : samples) {
+                values.push_back(double(sample.*field));
+                sum += values.back();
+            }
+            std::sort(values.begin(), values.end());
+            const auto percentile = [&values](double fraction) {
+                if (values.empty()) {
+                    return 0.0;
+                }
+                const auto rank = std::size_t(std::ceil(fraction * double(values.size())));
+                return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+            };
+            stream << "  \"" << name << "\": { "
+                   << "\"mean\": " << (values.empty() ? 0.0 : sum / double(values.size())) << ", "
+                   << "\"p50\": " << percentile(0.50) << ", "
+                   << "\"p99\": " << percentile(0.99) << ", "
+                   << "\"max\": " << (values.empty() ? 0.0 : values.back()) << " }";
+        }
+
+        static std::string escaped(const std::string& text) {
+            std::string out;
+            for (const char character : text) {
+                if (character == '"' || character == '\\') {
+                    out += '\\';
+                }
+                out += character;
+            }
+            return out;
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "type_name.hpp"
+
+namespace hyp {
+
+    template<typename... Component>
+    struct Reads {};
+
+    template<typename... Component>
+    struct Writes {};
+
+    /**
+     * 🕸 One frame's systems and the order they have to respect.
+     * Each system declares the components it reads and writes. Two systems conflict when one writes
+     * what the other reads or writes, and conflicting systems run in the order they were added.
+     * Everything else is free to run at the same time, so the graph is only as serial as the data forces it to be.
+     * Systems are free to parallel_for on the same pool from inside.
+     */
+    class FrameGraph {
+    public:
+        template<typename... Read, typename... Write, typename Body>
+        FrameGraph& add(std::string name, Reads<Read...>, Writes<Write...>, Body&& body) {
+            System system{
+                std::move(name),
+                {detail::qualified_name<Read>()...},
+                {detail::qualified_name<Write>()...},
+                std::forward<Body>(body),
+            };
+            for (std::size_t earlier = 0; earlier < systems.size(); ++earlier) {
+                if (conflict(systems[earlier], system)) {
+                    systems[earlier].dependents.push_back(systems.size());
+                    ++system.dependencies;
+                }
+            }
+            systems.push_back(std::move(system));
+            waiting = std::make_unique<std::atomic<std::size_t>[]>(systems.size());
+            return *this;
+        }
+
+        std::size_t size() const {
+            return systems.size();
+        }
+
+        /**
+         * 🏁 Run every system once on `pool`, returns when the last one has finished.
+         * The calling thread takes part.
+         */
+        void run(ThreadPool& pool) {
+            if (systems.empty()) {
+                return;
+            }
+            running_on = &pool;
+            for (std::size_t i = 0; i < systems.size(); ++i) {
+                waiting[i].store(systems[i].dependencies, std::memory_order_relaxed);
+            }
+            unfinished.store(systems.size(), std::memory_order_relaxed);
+            for (std::size_t i = 0; i < systems.size(); ++i) {
+                if (systems[i].dependencies == 0) {
+                    start(i);
+                }
+            }
+            pool.help_until([this] { return unfinished.load(std::memory_order_acquire) == 0; });
+        }
+
+        void run() {
+            run(ThreadPool::shared());
+        }
+
+        /**
+         * 📜 Every system with what it waits on, for checking the derived order
+         */
+        void describe(std::ostream& stream) const {
+            for (std::size_t i = 0; i < systems.size(); ++i) {
+                stream << systems[i].name << " after:";
+                for (std::size_t earlier = 0; earlier < i; ++earlier) {
+                    const auto& dependents = systems[earlier].dependents;
+                    if (std::find(dependents.begin(), dependents.end(), i) != dependents.end()) {
+                        stream << " " << systems[earlier].name;
+                    }
+                }
+                stream << std::endl;
+            }
+        }
+
+    private:
+        struct System {
+            std::string name;
+            std::vector<std::string_view> reads;
+            std::vector<std::string_view> writes;
+            std::function<void()> body;
+            std::vector<std::size_t> dependents{};
+            std::size_t dependencies = 0;
+        };
+
+        std::vector<System> systems;
+        // Per system, how many of its dependencies haven't finished yet this run
+        std::unique_ptr<std::atomic<std::size_t>[]> waiting;
+        std::atomic<std::size_t> unfinished{0};
+        ThreadPool* running_on = nullptr;
+
+        static bool overlap(const std::vector<std::string_view>& left, const std::vector<std::string_view>& right) {
+            return std::any_of(left.begin(), left.end(), [&right](std::string_view component) {
+                return std::find(right.begin(), right.end(), component) != right.end();
+            });
+        }
+
+        static bool conflict(const System& earlier, const System& later) {
+            return overlap(earlier.writes, later.reads) || overlap(earlier.writes, later.writes) ||
+                   overlap(earlier.reads, later.writes);
+        }
+
+        // Captures stay within std::function's inline storage, starting a system doesn't allocate
+        void start(std::size_t index) {
+            running_on->submit([this, index] {
+                systems[index].body();
+                for (const std::size_t dependent : systems[index].dependents) {
+                    if (waiting[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        start(dependent);
+                    }
+                }
+                unfinished.fetch_sub(1, std::memory_order_release);
+            });
+        }
+    };
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace hyp::gl {
+
+    /**
+     * 📋 GL entry points the recorder hooks, everything the draw path touches.
+     * X(name, kind) - name without the gl prefix, kind says what the call is counted as.
+     */
+    #define HYP_GL_RECORDED(X) \
+        X(UseProgram, program) \
+        X(BindBuffer, bind) \
+        X(BindBufferRange, bind) \
+        X(BindVertexArray, bind) \
+        X(BufferData, upload) \
+        X(BufferSubData, upload) \
+        X(MapBufferRange, upload) \
+        X(UnmapBuffer, state) \
+        X(GenBuffers, object) \
+        X(DeleteBuffers, object) \
+        X(GenVertexArrays, object) \
+        X(DeleteVertexArrays, object) \
+        X(EnableVertexAttribArray, state) \
+        X(DisableVertexAttribArray, state) \
+        X(VertexAttribPointer, state) \
+        X(VertexAttribDivisor, state) \
+        X(Uniform1fv, uniform) \
+        X(Uniform2fv, uniform) \
+        X(Uniform3fv, uniform) \
+        X(Uniform4fv, uniform) \
+        X(UniformMatrix4fv, uniform) \
+        X(GetAttribLocation, query) \
+        X(GetUniformLocation, query) \
+        X(GetUniformBlockIndex, query) \
+        X(FenceSync, sync) \
+        X(ClientWaitSync, sync) \
+        X(DeleteSync, sync) \
+        X(Clear, draw) \
+        X(DrawArrays, draw) \
+        X(DrawArraysInstanced, draw)
+
+    enum class CallKind {
+        program,
+        bind,
+        upload,
+        object,
+        state,
+        uniform,
+        query,
+        sync,
+        draw,
+    };
+
+    enum class Call {
+        #define HYP_GL_CALL_ENUM(name, kind) name,
+        HYP_GL_RECORDED(HYP_GL_CALL_ENUM)
+        #undef HYP_GL_CALL_ENUM
+        count,
+    };
+
+    constexpr std::string_view call_name(Call call) {
+        constexpr std::string_view names[] = {
+            #define HYP_GL_CALL_NAME(name, kind) "gl" #name,
+            HYP_GL_RECORDED(HYP_GL_CALL_NAME)
+            #undef HYP_GL_CALL_NAME
+        };
+        return names[std::size_t(call)];
+    }
+
+    constexpr CallKind call_kind(Call call) {
+        constexpr CallKind kinds[] = {
+            #define HYP_GL_CALL_KIND(name, kind) CallKind::kind,
+            HYP_GL_RECORDED(HYP_GL_CALL_KIND)
+            #undef HYP_GL_CALL_KIND
+        };
+        return kinds[std::size_t(call)];
+    }
+
+    struct CallCounters {
+        std::size_t calls = 0;
+        std::size_t draw_calls = 0;
+        std::size_t location_queries = 0;
+        std::size_t redundant_use_program = 0;
+        std::size_t redundant_bind_buffer = 0;
+        std::array<std::size_t, std::size_t(Call::count)> per_call{};
+    };
+
+    inline std::ostream& operator<<(std::ostream& stream, const CallCounters& counters) {
+        stream << counters.calls << " GL calls, " << counters.draw_calls << " draws, "
+               << counters.redundant_use_program << " redundant glUseProgram, "
+               << counters.redundant_bind_buffer << " redundant glBindBuffer, "
+               << counters.location_queries << " location queries";
+        return stream;
+    }
+
+    /**
+     * 🎙 Swaps glad's function pointers for recording ones while alive, then puts them back.
+     * Every hooked call is counted and, with `log` on, its entry point appended to the frame's
+     * call list, in order and without arguments; glUseProgram/glBindBuffer that re-bind what's
+     * already bound count as redundant. Calls go on to the driver, so a context has to be current.
+     * Only one recorder may be alive, and only the GL thread may call.
+     */
+    class Recorder {
+    public:
+        explicit Recorder(bool log = false) :
+            log{log} {
+            assert(!active && "only one gl::Recorder at a time");
+            active = this;
+            #define HYP_GL_INSTALL(name, kind) \
+                Hook<Call::name, &glad_gl##name>::original = glad_gl##name; \
+                glad_gl##name = &Hook<Call::name, &glad_gl##name>::record;
+            HYP_GL_RECORDED(HYP_GL_INSTALL)
+            #undef HYP_GL_INSTALL
+        }
+
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        ~Recorder() {
+            #define HYP_GL_RESTORE(name, kind) glad_gl##name = Hook<Call::name, &glad_gl##name>::original;
+            HYP_GL_RECORDED(HYP_GL_RESTORE)
+            #undef HYP_GL_RESTORE
+            active = nullptr;
+        }
+
+        /**
+         * 🔁 Start counting a new frame, frame() and calls() only cover what follows
+         */
+        void begin_frame() {
+            frame_counters = {};
+            frame_calls.clear();
+        }
+
+        const CallCounters& frame() const {
+            return frame_counters;
+        }
+
+        const CallCounters& total() const {
+            return total_counters;
+        }
+
+        std::span<const Call> calls() const {
+            return frame_calls;
+        }
+
+    private:
+        template<Call call, auto* slot>
+        struct Hook;
+
+        template<Call call, typename Result, typename... Args, Result (APIENTRYP* slot)(Args...)>
+        struct Hook<call, slot> {
+            static inline Result (APIENTRYP original)(Args...) = nullptr;
+
+            static Result APIENTRY record(Args... args) {
+                active->template observe<call>(args...);
+                return original(args...);
+            }
+        };
+
+        static inline Recorder* active = nullptr;
+
+        const bool log;
+        CallCounters frame_counters;
+        CallCounters total_counters;
+        std::vector<Call> frame_calls;
+        GLuint bound_program = 0;
+        // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER and GL_UNIFORM_BUFFER, the targets we bind
+        std::array<GLuint, 3> bound_buffers{};
+        bool binding_known = false;
+
+        template<Call call, typename... Args>
+        void observe(Args... args) {
+            bool redundant_program = false;
+            bool redundant_buffer = false;
+            if constexpr (call == Call::UseProgram) {
+                const GLuint program = GLuint(args...);
+                redundant_program = binding_known && program == bound_program;
+                bound_program = program;
+                binding_known = true;
+            }
+            if constexpr (call == Call::BindBuffer) {
+                const auto [target, buffer] = std::array<GLuint, 2>{GLuint(args)...};
+                const int slot = target == GL_ARRAY_BUFFER ? 0 : target == GL_ELEMENT_ARRAY_BUFFER ? 1
+                               : target == GL_UNIFORM_BUFFER ? 2 : -1;
+                if (slot >= 0) {
+                    redundant_buffer = bound_buffers[slot] == buffer && buffer != 0;
+                    bound_buffers[slot] = buffer;
+                }
+            }
+            if constexpr (call == Call::BindVertexArray) {
+                // The element buffer binding belongs to the vertex array
+                bound_buffers[1] = 0;
+            }
+            for (auto* counters : {&frame_counters, &total_counters}) {
+                ++counters->calls;
+                ++counters->per_call[std::size_t(call)];
+                counters->draw_calls += call_kind(call) == CallKind::draw && call != Call::Clear;
+                counters->location_queries += call_kind(call) == CallKind::query;
+                counters->redundant_use_program += redundant_program;
+                counters->redundant_bind_buffer += redundant_buffer;
+            }
+            if (log) {
+                frame_calls.push_back(call);
+            }
+        }
+    };
+}
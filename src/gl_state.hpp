@@ -0,0 +1,250 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace hyp::gl {
+
+    struct StateCounters {
+        std::size_t issued = 0;
+        std::size_t eliminated = 0;
+        std::size_t eliminated_programs = 0;
+        std::size_t eliminated_buffers = 0;
+        std::size_t eliminated_attributes = 0;
+        std::size_t eliminated_uniforms = 0;
+    };
+
+    inline std::ostream& operator<<(std::ostream& stream, const StateCounters& counters) {
+        return stream << counters.issued << " state calls issued, " << counters.eliminated << " eliminated ("
+                      << counters.eliminated_programs << " program, " << counters.eliminated_buffers << " buffer, "
+                      << counters.eliminated_attributes << " attribute, " << counters.eliminated_uniforms << " uniform)";
+    }
+
+    /**
+     * 🪞 Shadow copy of the GL state we change, every setter skips the call when GL already
+     * has that value. Covers the current program, buffer bindings, the bound vertex array with
+     * the attribute setup of each one, and uniform values per program. Anything that changes state behind its back has to call
+     * invalidate(), after which the next call of each kind always goes through.
+     * GL thread only, like the context it mirrors.
+     */
+    class StateCache {
+    public:
+        StateCounters frame;
+        StateCounters total;
+
+        void begin_frame() {
+            frame = {};
+        }
+
+        void invalidate() {
+            program = unknown;
+            buffers.fill(unknown);
+            buffers.back() = 0;
+            vertex_array = unknown;
+            vertex_arrays.clear();
+            attributes = &vertex_arrays[unknown];
+            uniforms.clear();
+        }
+
+        void use_program(GLuint id) {
+            if (skip(program == id, &StateCounters::eliminated_programs)) {
+                return;
+            }
+            program = id;
+            glUseProgram(id);
+        }
+
+        GLuint current_program() const {
+            return program;
+        }
+
+        void bind_buffer(GLenum target, GLuint buffer) {
+            GLuint& bound = buffers[target_slot(target)];
+            if (skip(bound == buffer && &bound != &buffers.back(), &StateCounters::eliminated_buffers)) {
+                return;
+            }
+            bound = buffer;
+            glBindBuffer(target, buffer);
+        }
+
+        /**
+         * Indexed bind, which also replaces the generic binding of `target`
+         */
+        void bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+            count_issued();
+            buffers[target_slot(target)] = buffer;
+            glBindBufferRange(target, index, buffer, offset, size);
+        }
+
+        /**
+         * GL drops a deleted buffer from every binding, the shadow has to follow
+         */
+        void forget_buffer(GLuint buffer) {
+            for (auto& bound : buffers) {
+                if (bound == buffer) {
+                    bound = 0;
+                }
+            }
+            for (auto& [id, array] : vertex_arrays) {
+                for (auto& attribute : array) {
+                    if (attribute.buffer == buffer) {
+                        attribute.buffer = unknown;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Attribute setup and the element buffer live in the vertex array,
+         * so the attribute calls below apply to whichever one this bound last
+         */
+        void bind_vertex_array(GLuint array) {
+            if (skip(vertex_array == array, &StateCounters::eliminated_buffers)) {
+                return;
+            }
+            vertex_array = array;
+            attributes = &vertex_arrays[array];
+            buffers[target_slot(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+            glBindVertexArray(array);
+        }
+
+        /**
+         * Deleting the bound vertex array falls back to the default one
+         */
+        void forget_vertex_array(GLuint array) {
+            vertex_arrays.erase(array);
+            if (vertex_array == array) {
+                vertex_array = 0;
+                buffers[target_slot(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+            }
+            attributes = &vertex_arrays[vertex_array];
+        }
+
+        void enable_attribute(GLint location) {
+            Attribute& attribute = attribute_at(location);
+            if (skip(attribute.enabled, &StateCounters::eliminated_attributes)) {
+                return;
+            }
+            attribute.enabled = true;
+            glEnableVertexAttribArray(GLuint(location));
+        }
+
+        /**
+         * Attribute source, compared together with the buffer bound to GL_ARRAY_BUFFER since that's what GL captures
+         */
+        void attribute_pointer(GLint location, GLint size, GLenum type, GLboolean normalized, GLsizei stride, std::uintptr_t offset) {
+            Attribute& attribute = attribute_at(location);
+            const GLuint buffer = buffers[target_slot(GL_ARRAY_BUFFER)];
+            const bool same = attribute.buffer == buffer && attribute.size == size && attribute.type == type &&
+                              attribute.normalized == normalized && attribute.stride == stride && attribute.offset == offset;
+            if (skip(same && buffer != unknown, &StateCounters::eliminated_attributes)) {
+                return;
+            }
+            attribute.buffer = buffer;
+            attribute.size = size;
+            attribute.type = type;
+            attribute.normalized = normalized;
+            attribute.stride = stride;
+            attribute.offset = offset;
+            glVertexAttribPointer(GLuint(location), size, type, normalized, stride, reinterpret_cast<const void*>(offset));
+        }
+
+        void attribute_divisor(GLint location, GLuint divisor) {
+            Attribute& attribute = attribute_at(location);
+            if (skip(attribute.divisor == divisor, &StateCounters::eliminated_attributes)) {
+                return;
+            }
+            attribute.divisor = divisor;
+            glVertexAttribDivisor(GLuint(location), divisor);
+        }
+
+        /**
+         * ❓ Whether `bytes` differ from what the current program's `location` was last set to,
+         * remembers them if so. The caller issues the glUniform* call when this returns true.
+         */
+        bool uniform_changed(GLint location, const void* bytes, std::size_t size) {
+            if (location < 0 || program == unknown) {
+                count_issued();
+                return location >= 0;
+            }
+            auto& shadow = uniforms[(std::uint64_t(program) << 32) | std::uint32_t(location)];
+            const bool same = shadow.size() == size && std::memcmp(shadow.data(), bytes, size) == 0;
+            if (skip(same, &StateCounters::eliminated_uniforms)) {
+                return false;
+            }
+            shadow.resize(size);
+            std::memcpy(shadow.data(), bytes, size);
+            return true;
+        }
+
+    private:
+        static constexpr GLuint unknown = ~GLuint{0};
+
+        struct Attribute {
+            bool enabled = false;
+            GLuint buffer = unknown;
+            GLint size = 0;
+            GLenum type = 0;
+            GLboolean normalized = GL_FALSE;
+            GLsizei stride = 0;
+            std::uintptr_t offset = 0;
+            GLuint divisor = unknown;
+        };
+
+        GLuint program = 0;
+        // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, then one slot that never skips
+        std::array<GLuint, 4> buffers{};
+        GLuint vertex_array = 0;
+        std::unordered_map<GLuint, std::vector<Attribute>> vertex_arrays;
+        std::vector<Attribute>* attributes = &vertex_arrays[0];
+        Attribute scratch;
+        std::unordered_map<std::uint64_t, std::vector<std::byte>> uniforms;
+
+        static std::size_t target_slot(GLenum target) {
+            switch (target) {
+                case GL_ARRAY_BUFFER: return 0;
+                case GL_ELEMENT_ARRAY_BUFFER: return 1;
+                case GL_UNIFORM_BUFFER: return 2;
+                default: return 3;
+            }
+        }
+
+        Attribute& attribute_at(GLint location) {
+            // Missing attributes (-1) share a scratch entry, GL rejects the call anyway
+            if (location < 0) {
+                scratch = {};
+                return scratch;
+            }
+            if (std::size_t(location) >= attributes->size()) {
+                attributes->resize(std::size_t(location) + 1);
+            }
+            return (*attributes)[std::size_t(location)];
+        }
+
+        void count_issued() {
+            ++frame.issued;
+            ++total.issued;
+        }
+
+        bool skip(bool redundant, std::size_t StateCounters::* kind) {
+            if (!redundant) {
+                count_issued();
+                return false;
+            }
+            for (auto* counters : {&frame, &total}) {
+                ++counters->eliminated;
+                ++(counters->*kind);
+            }
+            return true;
+        }
+    };
+
+    inline StateCache state;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace hyp {
+
+    /**
+     * #️⃣ FNV-1a, cheap enough to fingerprint every chunk on write and every shader on startup
+     */
+    inline std::uint64_t hash_bytes(std::span<const std::byte> bytes, std::uint64_t hash = 0xcbf29ce484222325) {
+        for (const std::byte byte : bytes) {
+            hash = (hash ^ static_cast<std::uint64_t>(byte)) * 0x100000001b3;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <iostream>
+
+#include <glad/glad.h>
+
+#if defined(HYP_HEADLESS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace hyp::gl {
+
+    /**
+     * 🕶 GL context with no window, rendering into an offscreen framebuffer.
+     * Uses EGL on Mesa's surfaceless platform, so it runs on llvmpipe without a display server.
+     * Falsy if any step failed, the reason is printed to std::cerr.
+     */
+    class HeadlessContext {
+    public:
+        HeadlessContext([[maybe_unused]] int width, [[maybe_unused]] int height) {
+#if defined(HYP_HEADLESS_EGL)
+            const auto get_platform_display =
+                reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            display = get_platform_display
+                ? get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            EGLint major, minor;
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+                std::cerr << "headless: no EGL display" << std::endl;
+                return;
+            }
+
+            const EGLint config_attributes[] = {
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_NONE,
+            };
+            EGLConfig config;
+            EGLint configs = 0;
+            if (!eglChooseConfig(display, config_attributes, &config, 1, &configs) || configs == 0) {
+                std::cerr << "headless: no EGL config for desktop GL" << std::endl;
+                return;
+            }
+
+            eglBindAPI(EGL_OPENGL_API);
+            context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+            if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+                std::cerr << "headless: couldn't make a surfaceless GL context current" << std::endl;
+                return;
+            }
+            if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+                std::cerr << "headless: couldn't load GL functions" << std::endl;
+                return;
+            }
+
+            glGenRenderbuffers(1, &color);
+            glBindRenderbuffer(GL_RENDERBUFFER, color);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glGenFramebuffers(1, &framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "headless: offscreen framebuffer incomplete" << std::endl;
+                return;
+            }
+            glViewport(0, 0, width, height);
+            ready = true;
+#else
+            std::cerr << "headless: built without EGL support" << std::endl;
+#endif
+        }
+
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+        ~HeadlessContext() {
+#if defined(HYP_HEADLESS_EGL)
+            if (framebuffer) {
+                glDeleteFramebuffers(1, &framebuffer);
+                glDeleteRenderbuffers(1, &color);
+            }
+            if (context != EGL_NO_CONTEXT) {
+                eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                eglDestroyContext(display, context);
+            }
+            if (display != EGL_NO_DISPLAY) {
+                eglTerminate(display);
+            }
+#endif
+        }
+
+        explicit operator bool() const {
+            return ready;
+        }
+
+    private:
+        bool ready = false;
+        GLuint framebuffer = 0;
+        GLuint color = 0;
+#if defined(HYP_HEADLESS_EGL)
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+#endif
+    };
+}
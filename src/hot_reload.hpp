@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "file_watcher.hpp"
+#include "hyper_file.hpp"
+#include "hyper_text.hpp"
+#include "world_stream.hpp"
+
+namespace hyp::hyper {
+
+    struct Diff {
+        std::size_t changed = 0;
+        std::size_t added = 0;
+        std::size_t removed = 0;
+        // Chunks whose hash changed, the only ones read and compared
+        std::size_t chunks_read = 0;
+    };
+
+    /**
+     * 🧱 A run of rows and the hash of their contents in the file
+     */
+    struct RowChunk {
+        std::uint64_t first = 0;
+        std::uint64_t count = 0;
+        std::uint64_t hash = 0;
+
+        bool operator==(const RowChunk&) const = default;
+    };
+
+    inline bool chunk_changed(std::span<const RowChunk> chunks, std::span<const RowChunk> previous, std::size_t index) {
+        return index >= previous.size() || chunks[index] != previous[index];
+    }
+
+    /**
+     * 🩹 Make the Record column of `archetype` equal the table that `chunks` cover, row for row.
+     * `previous` are the chunks the archetype was last made equal to; chunks identical to those,
+     * same rows and same hash, are skipped without reading them. load(const RowChunk&) is called once
+     * per remaining chunk, in order, and returns its records. Only rows that differ are written,
+     * rows past the end are popped and new ones appended with default values for other components.
+     * Pass a ChangeTracker instead of the archetype and every written row is marked too.
+     */
+    template<typename Record, typename ArchetypeType, typename Load>
+    Diff apply_chunks(ArchetypeType& archetype, std::span<const RowChunk> chunks, std::span<const RowChunk> previous,
+                      Load&& load) {
+        Diff diff;
+        const std::size_t rows = chunks.empty() ? 0 : chunks.back().first + chunks.back().count;
+        const std::size_t common = std::min(archetype.size(), rows);
+
+        while (archetype.size() > rows) {
+            archetype.remove(archetype.size() - 1);
+            ++diff.removed;
+        }
+        if (rows > common) {
+            diff.added = rows - common;
+            std::apply([&](const auto&... defaults) {
+                archetype.add_many(diff.added, defaults...);
+            }, typename ArchetypeType::Components{});
+        }
+
+        auto live = archetype.template column<Record>();
+        for (std::size_t index = 0; index < chunks.size(); ++index) {
+            if (!chunk_changed(chunks, previous, index)) {
+                continue;
+            }
+            const RowChunk& chunk = chunks[index];
+            const std::span<const Record> records = load(chunk);
+            ++diff.chunks_read;
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                const std::size_t row = chunk.first + i;
+                if (row >= common) {
+                    live[row] = records[i];
+                } else if (std::memcmp(&live[row], &records[i], sizeof(Record)) != 0) {
+                    live[row] = records[i];
+                    ++diff.changed;
+                    if constexpr (requires { archetype.template mark<Record>(row); }) {
+                        archetype.template mark<Record>(row);
+                    }
+                }
+            }
+        }
+        return diff;
+    }
+
+    /**
+     * 🔥 Keeps an archetype in sync with one table of a .hyper file while the game runs.
+     * The table is hashed in chunks and only chunks whose hash changed since the last reload are
+     * read: chunked worlds bring their own per-chunk hashes, other binary tables are hashed in runs
+     * of rows_per_chunk, and text tables hash each run's lines and only parse the runs that changed.
+     * Within those chunks only the rows that differ are written into the live store.
+     * Skipping relies on the archetype's Record column only being written through this reload.
+     * A file that fails to load leaves the store untouched.
+     */
+    template<typename Record>
+    class HotReload {
+    public:
+        static constexpr std::size_t rows_per_chunk = 256;
+
+        struct Stats {
+            std::uint64_t reloads = 0;
+            std::uint64_t failures = 0;
+            Diff last;
+            double last_ms = 0;
+        };
+
+        HotReload(std::filesystem::path path, std::string table) :
+            path{std::move(path)},
+            table{std::move(table)},
+            watcher{{this->path}} {
+        }
+
+        /**
+         * 🔄 Call at a frame boundary, applies the file to `archetype` if it changed.
+         * `archetype` can also be its ChangeTracker, to have the reload's changes published.
+         * Returns whether anything was applied.
+         */
+        template<typename ArchetypeType>
+        bool poll(ArchetypeType& archetype) {
+            if (watcher.poll().empty()) {
+                return false;
+            }
+            return reload(archetype);
+        }
+
+        /**
+         * 📥 Load the file now and apply it, regardless of whether it changed
+         */
+        template<typename ArchetypeType>
+        bool reload(ArchetypeType& archetype) {
+            const auto start = std::chrono::steady_clock::now();
+            bool loaded = false;
+
+            std::vector<RowChunk> next;
+            if (is_binary()) {
+                const File file{path.string()};
+                const TableDescriptor* descriptor = file.find(table);
+                loaded = descriptor && file.matches<Record>(*descriptor);
+                if (loaded) {
+                    const auto records = file.table<Record>(table);
+                    chunk_binary(file, records, next);
+                    stats.last = apply_chunks<Record>(archetype, next, chunks, [records](const RowChunk& chunk) {
+                        return records.subspan(chunk.first, chunk.count);
+                    });
+                }
+            } else {
+                std::ifstream stream{path, std::ios::binary};
+                std::ostringstream source;
+                source << stream.rdbuf();
+                const std::string text = source.str();
+                std::vector<Record> parsed;
+                loaded = stream && parse_changed(text, next, parsed);
+                if (loaded) {
+                    std::size_t cursor = 0;
+                    stats.last = apply_chunks<Record>(archetype, next, chunks, [&](const RowChunk& chunk) {
+                        const auto records = std::span<const Record>{parsed}.subspan(cursor, chunk.count);
+                        cursor += chunk.count;
+                        return records;
+                    });
+                }
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            stats.last_ms = elapsed.count();
+            if (!loaded) {
+                ++stats.failures;
+                std::cerr << "hyper: couldn't reload table '" << table << "' from " << path << std::endl;
+                return false;
+            }
+            chunks = std::move(next);
+            ++stats.reloads;
+            return true;
+        }
+
+        const Stats& statistics() const {
+            return stats;
+        }
+
+    private:
+        const std::filesystem::path path;
+        const std::string table;
+        FileWatcher watcher;
+        Stats stats;
+        // What the archetype was last made equal to
+        std::vector<RowChunk> chunks;
+
+        static void hash_runs(std::span<const Record> records, std::vector<RowChunk>& out) {
+            for (std::size_t first = 0; first < records.size(); first += rows_per_chunk) {
+                const auto run = records.subspan(first, std::min(rows_per_chunk, records.size() - first));
+                out.push_back({first, run.size(), hash_bytes(std::as_bytes(run))});
+            }
+        }
+
+        /**
+         * Chunked worlds already store a hash per chunk, so unchanged chunks aren't even paged in.
+         * Any other table, or a chunk directory that doesn't tile the table, gets hashed in runs.
+         */
+        void chunk_binary(const File& file, std::span<const Record> records, std::vector<RowChunk>& out) const {
+            if (const TableDescriptor* directory = file.find("chunks");
+                directory && table == "records" && file.matches<ChunkDescriptor>(*directory)) {
+                std::uint64_t next_row = 0;
+                for (const auto& chunk : file.table<ChunkDescriptor>("chunks")) {
+                    if (chunk.first != next_row) {
+                        break;
+                    }
+                    out.push_back({chunk.first, chunk.count, chunk.hash});
+                    next_row += chunk.count;
+                }
+                if (next_row == records.size()) {
+                    return;
+                }
+                out.clear();
+            }
+            hash_runs(records, out);
+        }
+
+        /**
+         * 📝 Hash the table's record lines in runs of rows_per_chunk and parse only the runs that
+         * differ from `chunks`, into `parsed` back to back. Fails without touching anything if the
+         * table is missing, doesn't match Record or a line that had to be parsed is bad.
+         */
+        bool parse_changed(std::string_view source, std::vector<RowChunk>& out, std::vector<Record>& parsed) const {
+            constexpr std::size_t none = ~std::size_t{0};
+            std::vector<TextTable> tables;
+            std::vector<std::string_view> lines;
+            std::size_t owner = none;
+            const bool walked = walk_text(source, path.string(), tables, [&](TextTable& text, std::string_view line, auto) {
+                // The first table of that name, like the binary format's find()
+                if (text.name == table && (owner == none || owner == tables.size() - 1)) {
+                    owner = tables.size() - 1;
+                    lines.push_back(line);
+                }
+                return true;
+            });
+            if (owner == none) {
+                const auto found = std::find_if(tables.begin(), tables.end(), [this](const TextTable& text) {
+                    return text.name == table;
+                });
+                owner = found == tables.end() ? none : std::size_t(found - tables.begin());
+            }
+            if (!walked || owner == none || !tables[owner].template matches<Record>()) {
+                return false;
+            }
+            const TextTable& header = tables[owner];
+
+            constexpr std::byte line_break{'\n'};
+            for (std::size_t first = 0; first < lines.size(); first += rows_per_chunk) {
+                const std::size_t count = std::min(rows_per_chunk, lines.size() - first);
+                std::uint64_t hash = hash_bytes({});
+                for (const auto line : std::span{lines}.subspan(first, count)) {
+                    hash = hash_bytes(std::as_bytes(std::span{line.data(), line.size()}), hash);
+                    hash = hash_bytes({&line_break, 1}, hash);
+                }
+                out.push_back({first, count, hash});
+            }
+
+            for (std::size_t index = 0; index < out.size(); ++index) {
+                if (!chunk_changed(out, chunks, index)) {
+                    continue;
+                }
+                const std::size_t offset = parsed.size();
+                parsed.resize(offset + out[index].count);
+                for (std::size_t i = 0; i < out[index].count; ++i) {
+                    const std::size_t row = out[index].first + i;
+                    const auto fail = [&](std::string_view message) {
+                        std::cerr << "hyper: " << path.string() << ": record " << row << ": " << message << std::endl;
+                        return false;
+                    };
+                    if (!parse_record(header, lines[row], reinterpret_cast<std::byte*>(&parsed[offset + i]), fail)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool is_binary() const {
+            std::ifstream stream{path, std::ios::binary};
+            std::uint32_t leading = 0;
+            stream.read(reinterpret_cast<char*>(&leading), sizeof(leading));
+            return stream && leading == magic;
+        }
+    };
+}
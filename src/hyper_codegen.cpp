@@ -0,0 +1,140 @@
+/**
+    hyper_codegen <input.hyper> <output.hpp>
+
+    Compiles text .hyper tables into constexpr std::array definitions, so static world data
+    costs no allocation or parsing at startup. Layout static_asserts are emitted alongside,
+    so a record struct drifting away from its .hyper fields is a compile error.
+**/
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "hyper_text.hpp"
+
+using namespace std;
+using namespace hyp::hyper;
+
+/**
+ * Values with no C++ literal, spelled as expressions instead: inf, nan and INT32_MIN,
+ * whose "-2147483648" would be negating an int literal that's already out of range
+ */
+template<typename T>
+bool write_special(ostream& stream, T value) {
+    if constexpr (is_floating_point_v<T>) {
+        const char* type = is_same_v<T, float> ? "float" : "double";
+        if (isnan(value)) {
+            stream << "std::numeric_limits<" << type << ">::quiet_NaN()";
+            return true;
+        }
+        if (isinf(value)) {
+            stream << (value < 0 ? "-" : "") << "std::numeric_limits<" << type << ">::infinity()";
+            return true;
+        }
+    } else if constexpr (is_same_v<T, int32_t>) {
+        if (value == numeric_limits<int32_t>::min()) {
+            stream << "(-2147483647 - 1)";
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename T>
+void write_value(ostream& stream, const byte* record, uint32_t offset, const char* suffix) {
+    T value;
+    memcpy(&value, record + offset, sizeof(T));
+    if (write_special(stream, value)) {
+        return;
+    }
+    char text[64];
+    const auto end = to_chars(text, text + sizeof(text), value).ptr;
+    const string_view printed{text, size_t(end - text)};
+    stream << printed;
+    if constexpr (is_floating_point_v<T>) {
+        if (printed.find_first_of(".e") == string_view::npos) {
+            stream << ".0";
+        }
+    }
+    stream << suffix;
+}
+
+void write_table(ostream& stream, const TextTable& table) {
+    const auto split = table.record_type.rfind("::");
+    const string space = split == string::npos ? "" : table.record_type.substr(0, split);
+    const string type = split == string::npos ? table.record_type : table.record_type.substr(split + 2);
+
+    if (!space.empty()) {
+        stream << "namespace " << space << " {" << endl << endl;
+    }
+    stream << "static_assert(sizeof(" << type << ") == " << table.record_size << ", \""
+           << table.record_type << " doesn't match table '" << table.name << "'\");" << endl;
+    for (const auto& field : table.fields) {
+        stream << "static_assert(offsetof(" << type << ", " << field.name << ") == " << field.offset << ");" << endl;
+    }
+    stream << endl;
+
+    stream << "inline constexpr std::array<" << type << ", " << table.count() << "> " << table.name << " {{" << endl;
+    for (size_t row = 0; row < table.count(); ++row) {
+        const byte* record = table.records.data() + row * table.record_size;
+        stream << "    {";
+        for (size_t i = 0; i < table.fields.size(); ++i) {
+            const auto& field = table.fields[i];
+            stream << (i ? ", " : "");
+            switch (field.type) {
+                case FieldType::f32: write_value<float>(stream, record, field.offset, "f"); break;
+                case FieldType::f64: write_value<double>(stream, record, field.offset, ""); break;
+                case FieldType::i32: write_value<int32_t>(stream, record, field.offset, ""); break;
+                case FieldType::u32: write_value<uint32_t>(stream, record, field.offset, "u"); break;
+                case FieldType::u64: write_value<uint64_t>(stream, record, field.offset, "ull"); break;
+            }
+        }
+        stream << "}," << endl;
+    }
+    stream << "}};" << endl;
+
+    if (!space.empty()) {
+        stream << endl << "}" << endl;
+    }
+    stream << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        cerr << "usage: hyper_codegen <input.hyper> <output.hpp>" << endl;
+        return 1;
+    }
+
+    ifstream input{argv[1], ios::binary};
+    if (!input) {
+        cerr << "hyper_codegen: can't read '" << argv[1] << "'" << endl;
+        return 1;
+    }
+    ostringstream source;
+    source << input.rdbuf();
+
+    vector<TextTable> tables;
+    if (!parse_text(source.str(), argv[1], tables)) {
+        return 1;
+    }
+
+    ostringstream header;
+    header << "// Generated by hyper_codegen from " << argv[1] << ", edit that instead" << endl;
+    header << "#pragma once" << endl << endl;
+    header << "#include <array>" << endl;
+    header << "#include <cstddef>" << endl;
+    header << "#include <limits>" << endl << endl;
+    for (const auto& table : tables) {
+        write_table(header, table);
+    }
+
+    ofstream output{argv[2], ios::binary | ios::trunc};
+    output << header.str();
+    return output ? 0 : 1;
+}
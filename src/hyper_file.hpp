@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "hash.hpp"
+
+/**
+ * 💾 Binary .hyper files
+ *
+ * [FileHeader][TableDescriptor...][FieldDescriptor...] then one 64 byte aligned block per table.
+ * A table is a contiguous array of one trivially copyable record type, laid out exactly as in memory,
+ * so loading is an mmap plus a schema check and the records are used in place.
+ */
+namespace hyp::hyper {
+
+    constexpr std::uint32_t magic = 0x52505948; // "HYPR"
+    constexpr std::uint32_t version = 1;
+    constexpr std::size_t alignment = 64;
+
+    enum class FieldType : std::uint32_t {
+        f32,
+        f64,
+        i32,
+        u32,
+        u64,
+    };
+
+    template<typename T>
+    constexpr FieldType field_type() {
+        if constexpr (std::is_same_v<T, float>) {
+            return FieldType::f32;
+        } else if constexpr (std::is_same_v<T, double>) {
+            return FieldType::f64;
+        } else if constexpr (std::is_same_v<T, std::int32_t>) {
+            return FieldType::i32;
+        } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+            return FieldType::u32;
+        } else if constexpr (std::is_same_v<T, std::uint64_t>) {
+            return FieldType::u64;
+        } else {
+            static_assert(sizeof(T) == 0, "no .hyper field type for this member");
+        }
+    }
+
+    struct FieldDescriptor {
+        char name[24];
+        FieldType type;
+        std::uint32_t offset;
+    };
+
+    struct TableDescriptor {
+        char name[32];
+        char record_type[48];
+        std::uint64_t offset;
+        std::uint64_t count;
+        std::uint32_t record_size;
+        std::uint32_t record_alignment;
+        std::uint32_t first_field;
+        std::uint32_t field_count;
+    };
+
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t table_count;
+        std::uint32_t field_count;
+        std::uint64_t file_size;
+        std::uint64_t reserved;
+    };
+
+    /**
+     * 📐 Describes a record type to the file format, specialize per record:
+     *     static constexpr const char* type_name;
+     *     static constexpr std::array<FieldDescriptor, N> fields;
+     */
+    template<typename Record>
+    struct Schema;
+
+    #define HYPER_FIELD(record, member) \
+        hyp::hyper::FieldDescriptor{ #member, hyp::hyper::field_type<decltype(record::member)>(), offsetof(record, member) }
+
+    constexpr std::uint64_t align_up(std::uint64_t value, std::uint64_t to = alignment) {
+        return (value + to - 1) / to * to;
+    }
+
+    inline bool name_equals(const char* stored, std::size_t capacity, std::string_view name) {
+        return name.size() < capacity && std::strncmp(stored, name.data(), name.size()) == 0 && stored[name.size()] == '\0';
+    }
+
+    /**
+     * ✅ Stored record layout lines up field for field with Schema<Record>
+     */
+    template<typename Record>
+    bool schema_matches(const TableDescriptor& table, std::span<const FieldDescriptor> stored) {
+        constexpr auto& expected = Schema<Record>::fields;
+        if (table.record_size != sizeof(Record) || stored.size() != expected.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (!name_equals(stored[i].name, sizeof(stored[i].name), expected[i].name) ||
+                stored[i].type != expected[i].type || stored[i].offset != expected[i].offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 🗺 Read-only mapping of a .hyper file, tables are handed out as spans into the mapping
+     */
+    class File {
+    public:
+        File() = default;
+
+        explicit File(const std::string& path) {
+            if (!map(path)) {
+                unmap();
+                return;
+            }
+            if (!validate()) {
+                std::cerr << "hyper: '" << path << "' is not a version " << version << " .hyper file" << std::endl;
+                unmap();
+            }
+        }
+
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        File(File&& other) noexcept {
+            *this = std::move(other);
+        }
+
+        File& operator=(File&& other) noexcept {
+            if (this != &other) {
+                unmap();
+                std::swap(bytes, other.bytes);
+                std::swap(byte_count, other.byte_count);
+#if defined(_WIN32)
+                std::swap(file_handle, other.file_handle);
+                std::swap(mapping_handle, other.mapping_handle);
+#endif
+            }
+            return *this;
+        }
+
+        ~File() {
+            unmap();
+        }
+
+        explicit operator bool() const {
+            return bytes != nullptr;
+        }
+
+        std::span<const std::byte> data() const {
+            return {bytes, byte_count};
+        }
+
+        const FileHeader& header() const {
+            return *reinterpret_cast<const FileHeader*>(bytes);
+        }
+
+        std::span<const TableDescriptor> tables() const {
+            return {reinterpret_cast<const TableDescriptor*>(bytes + sizeof(FileHeader)), header().table_count};
+        }
+
+        std::span<const FieldDescriptor> fields(const TableDescriptor& table) const {
+            const auto* all = reinterpret_cast<const FieldDescriptor*>(tables().data() + header().table_count);
+            return {all + table.first_field, table.field_count};
+        }
+
+        const TableDescriptor* find(std::string_view name) const {
+            if (!bytes) {
+                return nullptr;
+            }
+            for (const auto& table : tables()) {
+                if (name_equals(table.name, sizeof(table.name), name)) {
+                    return &table;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * 📖 Records of table `name`, empty if missing or laid out differently from Schema<Record>
+         */
+        template<typename Record>
+        std::span<const Record> table(std::string_view name) const {
+            const TableDescriptor* table = find(name);
+            if (!table) {
+                return {};
+            }
+            if (!matches<Record>(*table)) {
+                std::cerr << "hyper: table '" << name << "' does not match " << Schema<Record>::type_name << std::endl;
+                return {};
+            }
+            return {reinterpret_cast<const Record*>(bytes + table->offset), static_cast<std::size_t>(table->count)};
+        }
+
+        template<typename Record>
+        bool matches(const TableDescriptor& table) const {
+            return schema_matches<Record>(table, fields(table));
+        }
+
+    private:
+        const std::byte* bytes = nullptr;
+        std::size_t byte_count = 0;
+#if defined(_WIN32)
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+        HANDLE mapping_handle = nullptr;
+#endif
+
+        bool map(const std::string& path) {
+#if defined(_WIN32)
+            file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &size) || size.QuadPart == 0) {
+                std::cerr << "hyper: can't open '" << path << "'" << std::endl;
+                return false;
+            }
+            mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_handle) {
+                return false;
+            }
+            bytes = static_cast<const std::byte*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+            byte_count = static_cast<std::size_t>(size.QuadPart);
+#else
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            struct stat status{};
+            if (descriptor < 0 || fstat(descriptor, &status) != 0 || status.st_size == 0) {
+                std::cerr << "hyper: can't open '" << path << "'" << std::endl;
+                if (descriptor >= 0) {
+                    ::close(descriptor);
+                }
+                return false;
+            }
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            ::close(descriptor);
+            if (mapping == MAP_FAILED) {
+                return false;
+            }
+            bytes = static_cast<const std::byte*>(mapping);
+            byte_count = static_cast<std::size_t>(status.st_size);
+#endif
+            return bytes != nullptr;
+        }
+
+        void unmap() {
+#if defined(_WIN32)
+            if (bytes) {
+                UnmapViewOfFile(bytes);
+            }
+            if (mapping_handle) {
+                CloseHandle(mapping_handle);
+            }
+            if (file_handle != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_handle);
+            }
+            mapping_handle = nullptr;
+            file_handle = INVALID_HANDLE_VALUE;
+#else
+            if (bytes) {
+                munmap(const_cast<std::byte*>(bytes), byte_count);
+            }
+#endif
+            bytes = nullptr;
+            byte_count = 0;
+        }
+
+        bool validate() const {
+            if (byte_count < sizeof(FileHeader)) {
+                return false;
+            }
+            const FileHeader& file = header();
+            if (file.magic != magic || file.version != version || file.file_size != byte_count) {
+                return false;
+            }
+            const std::uint64_t descriptors_end = sizeof(FileHeader) +
+                    std::uint64_t{file.table_count} * sizeof(TableDescriptor) +
+                    std::uint64_t{file.field_count} * sizeof(FieldDescriptor);
+            if (descriptors_end > byte_count) {
+                return false;
+            }
+            for (const auto& table : tables()) {
+                if (table.offset % alignment != 0 ||
+                    table.offset + table.count * table.record_size > byte_count ||
+                    std::uint64_t{table.first_field} + table.field_count > file.field_count) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /**
+     * ✍ Collects tables and writes them out in the layout File maps back in.
+     * Spans handed to table() must stay alive until write().
+     */
+    class Writer {
+    public:
+        template<typename Record>
+        Writer& table(std::string_view name, std::span<const Record> records) {
+            static_assert(std::is_trivially_copyable_v<Record>, ".hyper records are stored as raw bytes");
+            TableDescriptor table{};
+            copy_name(table.name, sizeof(table.name), name);
+            copy_name(table.record_type, sizeof(table.record_type), Schema<Record>::type_name);
+            table.count = records.size();
+            table.record_size = sizeof(Record);
+            table.record_alignment = alignof(Record);
+            table.first_field = static_cast<std::uint32_t>(fields.size());
+            table.field_count = static_cast<std::uint32_t>(Schema<Record>::fields.size());
+            fields.insert(fields.end(), Schema<Record>::fields.begin(), Schema<Record>::fields.end());
+            tables.push_back(table);
+            payloads.push_back(std::as_bytes(records));
+            return *this;
+        }
+
+        template<typename Records>
+        Writer& table(std::string_view name, const Records& records) {
+            return table(name, std::span<const typename Records::value_type>{records});
+        }
+
+        bool write(const std::string& path) {
+            std::uint64_t offset = align_up(sizeof(FileHeader) +
+                    tables.size() * sizeof(TableDescriptor) +
+                    fields.size() * sizeof(FieldDescriptor));
+            for (auto& table : tables) {
+                table.offset = offset;
+                offset = align_up(offset + table.count * table.record_size);
+            }
+
+            FileHeader file{};
+            file.magic = magic;
+            file.version = version;
+            file.table_count = static_cast<std::uint32_t>(tables.size());
+            file.field_count = static_cast<std::uint32_t>(fields.size());
+            file.file_size = offset;
+
+            std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+            if (!stream) {
+                std::cerr << "hyper: can't write '" << path << "'" << std::endl;
+                return false;
+            }
+            stream.write(reinterpret_cast<const char*>(&file), sizeof(file));
+            stream.write(reinterpret_cast<const char*>(tables.data()), std::streamsize(tables.size() * sizeof(TableDescriptor)));
+            stream.write(reinterpret_cast<const char*>(fields.data()), std::streamsize(fields.size() * sizeof(FieldDescriptor)));
+            for (std::size_t i = 0; i < tables.size(); ++i) {
+                pad_to(stream, tables[i].offset);
+                stream.write(reinterpret_cast<const char*>(payloads[i].data()), std::streamsize(payloads[i].size()));
+            }
+            pad_to(stream, file.file_size);
+            return static_cast<bool>(stream);
+        }
+
+    private:
+        std::vector<TableDescriptor> tables;
+        std::vector<FieldDescriptor> fields;
+        std::vector<std::span<const std::byte>> payloads;
+
+        static void copy_name(char* out, std::size_t capacity, std::string_view name) {
+            std::memcpy(out, name.data(), std::min(name.size(), capacity - 1));
+        }
+
+        static void pad_to(std::ofstream& stream, std::uint64_t offset) {
+            static constexpr std::array<char, alignment> zeros{};
+            const auto position = static_cast<std::uint64_t>(stream.tellp());
+            if (offset > position) {
+                stream.write(zeros.data(), std::streamsize(offset - position));
+            }
+        }
+    };
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hyper_file.hpp"
+
+/**
+ * 📝 Text .hyper tables, the hand-editable side of the format
+ *
+ *     # comment
+ *     table data World::Structure
+ *     field x f32
+ *     field y f32
+ *     0.0 0.0
+ *     1.5, -2
+ *
+ * Fields are packed with natural alignment, the same way the compiler lays out a struct of
+ * those members, so parsed records can be used directly as the C++ record type.
+ */
+namespace hyp::hyper {
+
+    constexpr std::uint32_t field_size(FieldType type) {
+        switch (type) {
+            case FieldType::f64:
+            case FieldType::u64: return 8;
+            default: return 4;
+        }
+    }
+
+    constexpr std::string_view to_string(FieldType type) {
+        switch (type) {
+            case FieldType::f32: return "f32";
+            case FieldType::f64: return "f64";
+            case FieldType::i32: return "i32";
+            case FieldType::u32: return "u32";
+            case FieldType::u64: return "u64";
+        }
+        return "?";
+    }
+
+    struct TextTable {
+        std::string name;
+        std::string record_type;
+        std::vector<FieldDescriptor> fields;
+        std::uint32_t record_size = 0;
+        std::uint32_t record_alignment = 1;
+        std::vector<std::byte> records;
+
+        std::size_t count() const {
+            return record_size ? records.size() / record_size : 0;
+        }
+
+        /**
+         * 📖 Records viewed as Record, empty if the layout doesn't match Schema<Record>
+         */
+        template<typename Record>
+        std::span<const Record> as() const {
+            if (!matches<Record>()) {
+                return {};
+            }
+            return {reinterpret_cast<const Record*>(records.data()), count()};
+        }
+
+        template<typename Record>
+        bool matches() const {
+            TableDescriptor table{};
+            table.record_size = record_size;
+            return schema_matches<Record>(table, fields);
+        }
+    };
+
+    namespace detail {
+
+        inline std::string_view next_token(std::string_view& line) {
+            const auto is_separator = [](char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; };
+            std::size_t begin = 0;
+            while (begin < line.size() && is_separator(line[begin])) {
+                ++begin;
+            }
+            std::size_t end = begin;
+            while (end < line.size() && !is_separator(line[end])) {
+                ++end;
+            }
+            const auto token = line.substr(begin, end - begin);
+            line.remove_prefix(end);
+            return token;
+        }
+
+        template<typename T>
+        bool append_value(std::byte* out, std::string_view token) {
+            T value{};
+            const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (error != std::errc{} || end != token.data() + token.size()) {
+                return false;
+            }
+            std::memcpy(out, &value, sizeof(T));
+            return true;
+        }
+
+        inline bool parse_field_type(std::string_view token, FieldType& type) {
+            for (const auto candidate : {FieldType::f32, FieldType::f64, FieldType::i32, FieldType::u32, FieldType::u64}) {
+                if (token == to_string(candidate)) {
+                    type = candidate;
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    /**
+     * 🚶 Read the tables and fields in `source` and hand every record line, comment stripped, to
+     * on_record(TextTable& table, std::string_view line, auto fail), which returns false to stop.
+     * Lines are left unparsed, so callers can skip the ones they don't need.
+     * Errors go to std::cerr prefixed with `origin` and line.
+     */
+    template<typename OnRecord>
+    bool walk_text(std::string_view source, std::string_view origin, std::vector<TextTable>& tables, OnRecord&& on_record) {
+        std::size_t line_number = 0;
+        const auto fail = [&](std::string_view message) {
+            std::cerr << "hyper: " << origin << ":" << line_number << ": " << message << std::endl;
+            return false;
+        };
+        // Records seen in the last table, which has to have all its fields by then
+        std::size_t records = 0;
+
+        while (!source.empty()) {
+            ++line_number;
+            const std::size_t line_end = std::min(source.find('\n'), source.size());
+            std::string_view line = source.substr(0, line_end);
+            source.remove_prefix(std::min(line_end + 1, source.size()));
+            if (const auto comment = line.find('#'); comment != std::string_view::npos) {
+                line = line.substr(0, comment);
+            }
+
+            std::string_view rest = line;
+            const std::string_view keyword = detail::next_token(rest);
+            if (keyword.empty()) {
+                continue;
+            }
+
+            if (keyword == "table") {
+                const auto name = detail::next_token(rest);
+                const auto record_type = detail::next_token(rest);
+                if (name.empty() || record_type.empty()) {
+                    return fail("expected 'table <name> <record type>'");
+                }
+                tables.push_back({std::string{name}, std::string{record_type}, {}, 0, 1, {}});
+                records = 0;
+                continue;
+            }
+            if (tables.empty()) {
+                return fail("data before the first 'table'");
+            }
+            TextTable& table = tables.back();
+
+            if (keyword == "field") {
+                if (records) {
+                    return fail("fields have to come before any records");
+                }
+                const auto name = detail::next_token(rest);
+                FieldDescriptor field{};
+                if (name.empty() || name.size() >= sizeof(field.name) ||
+                    !detail::parse_field_type(detail::next_token(rest), field.type)) {
+                    return fail("expected 'field <name> <f32|f64|i32|u32|u64>'");
+                }
+                const std::uint32_t size = field_size(field.type);
+                std::memcpy(field.name, name.data(), name.size());
+                field.offset = static_cast<std::uint32_t>(align_up(table.record_size, size));
+                table.record_alignment = std::max(table.record_alignment, size);
+                table.record_size = field.offset + size;
+                table.fields.push_back(field);
+                continue;
+            }
+
+            if (table.fields.empty()) {
+                return fail("records before any 'field'");
+            }
+            ++records;
+            if (!on_record(table, line, fail)) {
+                return false;
+            }
+        }
+
+        for (auto& table : tables) {
+            table.record_size = static_cast<std::uint32_t>(align_up(table.record_size, table.record_alignment));
+        }
+        return true;
+    }
+
+    /**
+     * 📖 Parse one record line of `table`, with its fields complete, into the record at `out`
+     */
+    template<typename Fail>
+    bool parse_record(const TextTable& table, std::string_view line, std::byte* out, Fail&& fail) {
+        for (const auto& field : table.fields) {
+            const auto token = detail::next_token(line);
+            bool parsed = false;
+            switch (field.type) {
+                case FieldType::f32: parsed = detail::append_value<float>(out + field.offset, token); break;
+                case FieldType::f64: parsed = detail::append_value<double>(out + field.offset, token); break;
+                case FieldType::i32: parsed = detail::append_value<std::int32_t>(out + field.offset, token); break;
+                case FieldType::u32: parsed = detail::append_value<std::uint32_t>(out + field.offset, token); break;
+                case FieldType::u64: parsed = detail::append_value<std::uint64_t>(out + field.offset, token); break;
+            }
+            if (!parsed) {
+                return fail("bad value for field '" + std::string{field.name} + "'");
+            }
+        }
+        if (!detail::next_token(line).empty()) {
+            return fail("more values than fields");
+        }
+        return true;
+    }
+
+    /**
+     * 🔍 Parse every table in `source`, errors go to std::cerr prefixed with `origin` and line
+     */
+    inline bool parse_text(std::string_view source, std::string_view origin, std::vector<TextTable>& tables) {
+        return walk_text(source, origin, tables, [](TextTable& table, std::string_view line, auto fail) {
+            // Not final until walk_text is done, the fields seen so far are all there is though
+            const std::size_t record_size = align_up(table.record_size, table.record_alignment);
+            const std::size_t offset = table.records.size();
+            table.records.resize(offset + record_size);
+            return parse_record(table, line, table.records.data() + offset, fail);
+        });
+    }
+}
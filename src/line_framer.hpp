@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace hyp {
+
+    struct FramerStats {
+        std::size_t packets = 0;
+        std::size_t bytes = 0;
+        std::size_t lines = 0;
+        // Lines that straddled a packet boundary and had to be stitched together in the carry buffer
+        std::size_t carried_lines = 0;
+        // Times a line outgrew the carry buffer, the only allocations after construction
+        std::size_t carry_growths = 0;
+    };
+
+    /**
+     * ✂ Cuts a byte stream arriving in arbitrary packets into delimiter-terminated lines.
+     * Delimiters are found with memchr. A line that lies inside one packet is handed
+     * out as a view straight into that packet. Only the unfinished tail of a packet is copied,
+     * into the carry buffer, and it's finished off by the next packets.
+     * Views passed to `on_line` are only valid during the call, and they don't include the delimiter.
+     */
+    class LineFramer {
+    public:
+        explicit LineFramer(char delimiter = '\r', std::size_t carry_capacity = 256) :
+            delimiter{delimiter},
+            carry(std::max<std::size_t>(carry_capacity, 1)) {
+        }
+
+        /**
+         * 📥 Frame one packet, calling `on_line(std::string_view)` for every line it completes
+         */
+        template<typename Byte, typename OnLine>
+        requires (sizeof(Byte) == 1)
+        void push(std::span<const Byte> packet, OnLine&& on_line) {
+            const char* cursor = reinterpret_cast<const char*>(packet.data());
+            const char* const end = cursor + packet.size();
+            ++counters.packets;
+            counters.bytes += packet.size();
+
+            while (true) {
+                const auto* const found = static_cast<const char*>(std::memchr(cursor, delimiter, std::size_t(end - cursor)));
+                if (!found) {
+                    append(cursor, end);
+                    return;
+                }
+                ++counters.lines;
+                if (carried == 0) {
+                    on_line(std::string_view{cursor, std::size_t(found - cursor)});
+                } else {
+                    append(cursor, found);
+                    ++counters.carried_lines;
+                    on_line(std::string_view{carry.data(), carried});
+                    carried = 0;
+                }
+                cursor = found + 1;
+            }
+        }
+
+        /**
+         * The unfinished line waiting for its delimiter
+         */
+        std::string_view pending() const {
+            return {carry.data(), carried};
+        }
+
+        void reset() {
+            carried = 0;
+        }
+
+        const FramerStats& stats() const {
+            return counters;
+        }
+
+    private:
+        const char delimiter;
+        std::vector<char> carry;
+        std::size_t carried = 0;
+        FramerStats counters;
+
+        void append(const char* first, const char* last) {
+            const auto size = std::size_t(last - first);
+            if (carried + size > carry.size()) {
+                carry.resize(std::max(carry.size() * 2, carried + size));
+                ++counters.carry_growths;
+            }
+            std::copy(first, last, carry.data() + carried);
+            carried += size;
+        }
+    };
+}
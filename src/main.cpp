@@ -1,5 +1,12 @@
+// 🧮 The game counts its heap allocations, defined first so no header sees the plain operator new
+#define HYP_COUNT_ALLOCATIONS
+#include "allocation_counter.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
-#include <sstream>
 #include <utility>
 #include <vector>
 #include <thread>
@@ -13,74 +20,68 @@
 #include <glm/gtc/type_ptr.inl>
 
 #include "entity.hpp"
+#include "archetype.hpp"
+#include "world.hyper"
+#include "hot_reload.hpp"
+#include "buffer_pool.hpp"
+#include "systems.hpp"
+#include "render_queue.hpp"
+#include "type_name.hpp"
+#include "shader_cache.hpp"
+#include "uniform_block.hpp"
+#include "headless_context.hpp"
+#include "frame_benchmark.hpp"
+#include "gl_recorder.hpp"
+#include "gl_state.hpp"
+#include "vertex_array_cache.hpp"
+#include "change_tracker.hpp"
+#include "frame_graph.hpp"
+#include "triple_buffer.hpp"
+#include "fixed_step_thread.hpp"
 
 class ShaderProgram {
 public:
 	const GLuint program;
-	const GLuint vertex_shader;
-	const GLuint fragment_shader;
 	ShaderProgram(
 		const char* vertex_shader_source,
 		const char* fragment_shader_source
 	) :
-		program{ glCreateProgram() },
-		vertex_shader{ glCreateShader(GL_VERTEX_SHADER) },
-		fragment_shader{ glCreateShader(GL_FRAGMENT_SHADER) }
+		program{ glCreateProgram() }
 	{
-		glShaderSource(vertex_shader, 1, &vertex_shader_source, nullptr);
-		glCompileShader(vertex_shader);
-		
-		GLint compileResult;
-		glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &compileResult);
-		if(compileResult != GL_TRUE) {
-            GLsizei logLength;
-            GLchar  log[1024];
-            glGetShaderInfoLog(vertex_shader, sizeof(log), &logLength, log);
-            std::cerr << "vertex_shader: " << std::endl << log << std::endl;
-		}
-
-		glShaderSource(fragment_shader, 1, &fragment_shader_source, nullptr);
-		glCompileShader(fragment_shader);
-		
-		glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &compileResult);
-		if(compileResult != GL_TRUE) {
-            GLsizei logLength;
-            GLchar  log[1024];
-            glGetShaderInfoLog(fragment_shader, sizeof(log), &logLength, log);
-            std::cerr << "fragment_shader: " << std::endl << log << std::endl;
-		}
-
-		glAttachShader(program, vertex_shader);
-		glAttachShader(program, fragment_shader);
-		glLinkProgram(program);
-
-        glGetProgramiv(program, GL_LINK_STATUS, &compileResult);
-        if(compileResult != GL_TRUE)
-        {
-            std::cerr << "Shader compilation of file '" << "foof" << "' failed." << std::endl;
-
-            GLsizei logLength;
-            GLchar  log[1024];
-            glGetProgramInfoLog(program, sizeof(log), &logLength, log);
-            std::cerr << "program: " << std::endl << log << std::endl;
-        }
+		const hyp::gl::StageSource stages[] = {
+			{ GL_VERTEX_SHADER, { vertex_shader_source } },
+			{ GL_FRAGMENT_SHADER, { fragment_shader_source } },
+		};
+		hyp::gl::build_program(program, stages);
 	}
 	explicit operator GLuint() const
 	{
 		return program;
 	}
+    /**
+     * 🔗 Attributes are recorded into the program's own vertex array,
+     * bind_vertex_array() before drawing restores all of them at once
+     */
     template<class T>
     void assign_buffer_from_vector(const std::string& name, std::vector<T> input) {
         const GLint location = glGetAttribLocation((GLuint)program, (GLchar*)name.data());
+        if (!vertex_array) {
+            glGenVertexArrays(1, &vertex_array);
+        }
+        hyp::gl::state.bind_vertex_array(vertex_array);
         GLuint vertex_buffer;
         glGenBuffers(1, &vertex_buffer);
-        glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+        hyp::gl::state.bind_buffer(GL_ARRAY_BUFFER, vertex_buffer);
         glBufferData(GL_ARRAY_BUFFER, input.size() * sizeof(T), &input[0], GL_STATIC_DRAW);
-        glEnableVertexAttribArray(location);
-        glVertexAttribPointer(location, std::tuple_size<T>::value, GL_FLOAT, GL_FALSE,
-                              sizeof(input[0]), (void*)nullptr);
-        std::cout << location << std::endl;
+        hyp::gl::state.enable_attribute(location);
+        hyp::gl::state.attribute_pointer(location, std::tuple_size<T>::value, GL_FLOAT, GL_FALSE,
+                                         sizeof(input[0]), 0);
     }
+    void bind_vertex_array() const {
+        hyp::gl::state.bind_vertex_array(vertex_array);
+    }
+private:
+    GLuint vertex_array = 0;
 };
 
 template<class T>
@@ -96,15 +97,21 @@ public:
 };
 template<>
 void Uniform<glm::mat4>::assign(glm::mat4 value) const {
-    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    if (hyp::gl::state.uniform_changed(location, &value, sizeof(value))) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    }
 }
 template<>
 void Uniform<glm::vec3>::assign(glm::vec3 value) const {
-    glUniform3fv(location, 1, glm::value_ptr(value));
+    if (hyp::gl::state.uniform_changed(location, &value, sizeof(value))) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
+    }
 }
 template<>
 void Uniform<glm::vec4>::assign(glm::vec4 value) const {
-    glUniform4fv(location, 1, glm::value_ptr(value));
+    if (hyp::gl::state.uniform_changed(location, &value, sizeof(value))) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
+    }
 }
 
 class FunShader : public ShaderProgram {
@@ -154,7 +161,7 @@ public:
 /** 😎 Objectives:
  * ✅ Take shader settings
  * ✅ Use to create shader
- * Use to create render command
+ * ✅ Use to create render command
  */
 namespace ShaderBuilder {
 
@@ -183,52 +190,106 @@ namespace ShaderBuilder {
     template<GLSLUnit unit>
     class Varying {};
 
+    constexpr GLint unit_length(GLSLUnit unit) {
+        switch (unit) {
+            case GLSLUnit::single: return 1;
+            case GLSLUnit::vec2: return 2;
+            case GLSLUnit::vec3: return 3;
+            case GLSLUnit::vec4: return 4;
+            case GLSLUnit::mat4: return 16;
+        }
+        return 0;
+    }
+
+    /**
+     * Instanced attributes advance once per instance instead of once per vertex
+     */
     template<GLSLUnit unit, bool instanced>
-    class Attribute {};
+    class Attribute {
+    public:
+        static constexpr GLSLUnit glsl_unit = unit;
+        static constexpr bool is_instanced = instanced;
+    };
 
     class Element {};
 
     template<GLSLUniformUnit unit, int count>
     class Uniform {
+    public:
+        static constexpr int element_count = count;
     };
 
-    // ⚠ MSVC specific class name gathering solution
-    template<class T>
-    string get_class_name(T member) {
-        string base_name = typeid(member).name();
-        int last_space = std::max(
-            base_name.find_last_of("::") + 1,
-            base_name.find_last_of(' '));
-        return base_name.substr(last_space);
-    }
+    /**
+     * Block of uniforms read from a buffer bound to `binding_point`, described by gl::BlockSchema<Layout>.
+     * One upload serves every program that declares the block.
+     */
+    template<class Layout, GLuint binding_point>
+    class UniformBlock {
+    public:
+        using layout = Layout;
+        static constexpr GLuint binding = binding_point;
+    };
 
-    template<class... T>
-    auto get_class_names(T... classes) {
-        return list{get_class_name(classes)...};
-    }
+    template<class Member>
+    constexpr bool is_uniform_block = false;
+
+    template<class Member> requires is_base_of_v<UniformBlock<typename Member::layout, Member::binding>, Member>
+    constexpr bool is_uniform_block<Member> = true;
+
+    /**
+     * ✏ Appends GLSL text inside a constant expression. Without a buffer it only counts,
+     * which is how the header's length is found before it is written.
+     */
+    struct GLSLWriter {
+        char* out = nullptr;
+        size_t length = 0;
+
+        constexpr GLSLWriter& operator<<(string_view text) {
+            for (const char character : text) {
+                if (out) {
+                    out[length] = character;
+                }
+                ++length;
+            }
+            return *this;
+        }
+
+        constexpr GLSLWriter& operator<<(int number) {
+            char digits[12]{};
+            size_t count = 0;
+            do {
+                digits[count++] = char('0' + number % 10);
+                number /= 10;
+            } while (number > 0);
+            while (count > 0) {
+                *this << string_view{ &digits[--count], 1 };
+            }
+            return *this;
+        }
+    };
 
     template<GLSLUnit unit, bool instanced>
-    void vert_text(ostream& stream, Attribute<unit, instanced> member, string name) {
+    constexpr void vert_text(GLSLWriter& stream, Attribute<unit, instanced> member, string_view name) {
         stream << "attribute ";
         switch (unit) {
-            case GLSLUnit::single: stream << "single "; break;
+            case GLSLUnit::single: stream << "float "; break;
             case GLSLUnit::vec2: stream << "vec2 "; break;
             case GLSLUnit::vec3: stream << "vec3 "; break;
             case GLSLUnit::vec4: stream << "vec4 "; break;
             case GLSLUnit::mat4: stream << "mat4 "; break;
         }
-        stream << name << ";" << endl;
+        stream << name << ";\n";
     }
 
     template<GLSLUniformUnit unit, int count>
-    void vert_text(ostream& stream, Uniform<unit, count> member, string name) {
+    constexpr void vert_text(GLSLWriter& stream, Uniform<unit, count> member, string_view name) {
         stream << "uniform ";
         // switch (unit) {
         //     case GLSLUniformUnit::sampler2D: break;
         //     default: stream << "highp ";
         // }
         switch (unit) {
-            case GLSLUniformUnit::single: stream << "single "; break;
+            case GLSLUniformUnit::single: stream << "float "; break;
             case GLSLUniformUnit::vec2: stream << "vec2 "; break;
             case GLSLUniformUnit::vec3: stream << "vec3 "; break;
             case GLSLUniformUnit::vec4: stream << "vec4 "; break;
@@ -239,7 +300,56 @@ namespace ShaderBuilder {
         if (count > 1) {
             stream << "[" << count << "]";
         }
-        stream << ";" << endl;
+        stream << ";\n";
+    }
+
+    template<class Layout, GLuint binding>
+    constexpr void vert_text(GLSLWriter& stream, UniformBlock<Layout, binding> member, string_view name) {
+        static_assert(gl::std140_matches<Layout>(), "uniform block layout doesn't follow std140");
+        stream << "layout(std140) uniform " << name << " {\n";
+        for (const auto& field : gl::BlockSchema<Layout>::fields) {
+            stream << "    " << field.type.glsl << " " << field.name << ";\n";
+        }
+        stream << "};\n";
+    }
+
+    /**
+     * 📝 GLSL declarations for every member, written by the compiler.
+     * Runs twice: once to measure, once into a FixedString of exactly that size.
+     */
+    template<class... Members>
+    constexpr auto make_vertex_header() {
+        constexpr size_t length = [] {
+            GLSLWriter counter;
+            (vert_text(counter, Members{}, type_name<Members>()), ...);
+            return counter.length;
+        }();
+        FixedString<length> header;
+        GLSLWriter writer{ header.characters };
+        (vert_text(writer, Members{}, type_name<Members>()), ...);
+        return header;
+    }
+
+    template<GLSLUnit unit, bool instanced>
+    GLint location_of(GLuint program, Attribute<unit, instanced> member, const char* name) {
+        return glGetAttribLocation(program, name);
+    }
+
+    template<GLSLUniformUnit unit, int count>
+    GLint location_of(GLuint program, Uniform<unit, count> member, const char* name) {
+        return glGetUniformLocation(program, name);
+    }
+
+    /**
+     * Blocks have no location, point the program's block at its binding instead
+     */
+    template<class Layout, GLuint binding>
+    GLint location_of(GLuint program, UniformBlock<Layout, binding> member, const char* name) {
+        const GLuint index = glGetUniformBlockIndex(program, name);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, index, binding);
+        }
+        return GLint(index);
     }
 
     template<class... Members>
@@ -247,125 +357,430 @@ namespace ShaderBuilder {
     public:
         GLuint program;
         Entity<Members...> members;
-        explicit Shader(char* vert_shader, char* frag_shader, Entity<Members...> members) : 
+        // One persistent buffer per member, indexed like `members`
+        array<gl::AttributeBuffer, sizeof...(Members)> buffers;
+        // Attribute or uniform location per member, resolved once after linking
+        array<GLint, sizeof...(Members)> locations;
+        // Where each attribute member currently reads from, uniform members stay empty
+        array<gl::AttributeSource, sizeof...(Members)> sources;
+        // One VAO per distinct `sources`, so a mesh seen before is a single glBindVertexArray
+        gl::VertexArrayCache vertex_arrays;
+        gl::ProgramBuild build;
+
+        template<class Member>
+        static constexpr size_t member_index = tuple_element_index_v<Member, tuple<Members...>>;
+
+        // 📝 GLSL declarations of every member, built at compile time
+        static constexpr auto vertex_header = make_vertex_header<Members...>();
+        // std140 blocks come from ARB_uniform_buffer_object, on 1.20 so attribute/varying/gl_FragColor stay valid
+        static constexpr string_view glsl_version = (is_uniform_block<Members> || ...)
+            ? "#version 120\n#extension GL_ARB_uniform_buffer_object : require\n"
+            : "#version 110\n";
+
+        explicit Shader(const char* vert_shader, const char* frag_shader, Entity<Members...> members) : 
             program{ glCreateProgram() },
             members{ members } {
-		    const auto vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-		    const auto fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-
-            ostringstream vertex_shader_stream;
-            vertex_shader_stream << "#version 110" << endl;
-            vertex_header(vertex_shader_stream);
-            vertex_shader_stream << endl << vert_shader;
-            const string vertex_shader_string = vertex_shader_stream.str();
-            const char* vertex_shader_source = vertex_shader_string.c_str();
-            cout << vertex_shader_source << endl;
-
-            ostringstream fragment_shader_stream;
-            fragment_shader_stream << "#version 110" << endl;
-            fragment_header(fragment_shader_stream);
-            fragment_shader_stream << endl << frag_shader;
-            const string fragment_shader_string = fragment_shader_stream.str();
-            const char* fragment_shader_source = fragment_shader_string.c_str();
-            cout << fragment_shader_source << endl;
-
-            glShaderSource(vertex_shader, 1, &vertex_shader_source, nullptr);
-            glCompileShader(vertex_shader);
-            
-            GLint compileResult;
-            glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &compileResult);
-            if(compileResult != GL_TRUE) {
-                GLsizei logLength;
-                GLchar  log[1024];
-                glGetShaderInfoLog(vertex_shader, sizeof(log), &logLength, log);
-                std::cerr << "vertex_shader: " << std::endl << log << std::endl;
-            }
+            gl::ShaderBuildQueue queue;
+            start(vert_shader, frag_shader, queue);
+            finish(queue);
+        }
 
-            glShaderSource(fragment_shader, 1, &fragment_shader_source, nullptr);
-            glCompileShader(fragment_shader);
-            
-            glGetShaderiv(fragment_shader, GL_COMPILE_STATUS, &compileResult);
-            if(compileResult != GL_TRUE) {
-                GLsizei logLength;
-                GLchar  log[1024];
-                glGetShaderInfoLog(fragment_shader, sizeof(log), &logLength, log);
-                std::cerr << "fragment_shader: " << std::endl << log << std::endl;
-            }
+        /**
+         * ⏩ Only starts the build, call finish() with the same queue before using the shader
+         */
+        Shader(const char* vert_shader, const char* frag_shader, Entity<Members...> members, gl::ShaderBuildQueue& queue) :
+            program{ glCreateProgram() },
+            members{ members } {
+            start(vert_shader, frag_shader, queue);
+        }
 
-            glAttachShader(program, vertex_shader);
-            glAttachShader(program, fragment_shader);
-            glLinkProgram(program);
+        /**
+         * ⏳ Wait for the build started by the constructor, then look up member locations
+         */
+        bool finish(gl::ShaderBuildQueue& queue) {
+            const bool built = queue.finish(build);
+            resolve_locations();
+            return built;
+        }
 
-            glGetProgramiv(program, GL_LINK_STATUS, &compileResult);
-            if(compileResult != GL_TRUE)
-            {
-                std::cerr << "Shader compilation of file '" << "foof" << "' failed." << std::endl;
+        void start(const char* vert_shader, const char* frag_shader, gl::ShaderBuildQueue& queue) {
+            // Version, header and body go to the driver as separate strings, nothing is concatenated
+            const gl::StageSource stages[] = {
+                { GL_VERTEX_SHADER, { glsl_version, vertex_header.view(), vert_shader } },
+                { GL_FRAGMENT_SHADER, { glsl_version, frag_shader } },
+            };
+            build = queue.submit(program, stages);
+        }
 
-                GLsizei logLength;
-                GLchar  log[1024];
-                glGetProgramInfoLog(program, sizeof(log), &logLength, log);
-                std::cerr << "program: " << std::endl << log << std::endl;
-            }
+        /**
+         * 📍 Ask the driver for every member's location once, binds only index `locations`
+         */
+        void resolve_locations() {
+            ((locations[member_index<Members>] = location_of(program, Members{}, type_name_v<Members>.text())), ...);
+        }
+
+        template<class Member>
+        GLint location() const {
+            return locations[member_index<Member>];
         }
 
-//        template<int count>
-//        void bind(Uniform<GLSLUniformUnit::single, count> member, const string& name, const float& uniform) {
-//            const auto location = glGetUniformLocation(program, name.data());
-//            glUniform1fv(location, 1, &uniform);
-//        }
         #define DEFINE_UNIFORM_BIND(unit, value_unit, gl_call, retrieval) \
-        template<int count> \
-        void bind(Uniform<GLSLUniformUnit::unit, count> member, const string& name, const value_unit& uniform) { \
-            const auto location = glGetUniformLocation(program, name.data()); \
-            gl_call(location, count, retrieval(uniform)); \
+        template<class Member> requires is_base_of_v<Uniform<GLSLUniformUnit::unit, Member::element_count>, Member> \
+        void bind(Member member, const value_unit& uniform) { \
+            if (gl::state.uniform_changed(location<Member>(), &uniform, sizeof(uniform))) { \
+                gl_call(location<Member>(), Member::element_count, retrieval(uniform)); \
+            } \
         }
         DEFINE_UNIFORM_BIND(single, float, glUniform1fv, &)
         DEFINE_UNIFORM_BIND(vec2, vec2, glUniform2fv, value_ptr)
         DEFINE_UNIFORM_BIND(vec3, vec3, glUniform3fv, value_ptr)
         DEFINE_UNIFORM_BIND(vec4, vec4, glUniform4fv, value_ptr)
         // DEFINE_UNIFORM_BIND(mat4, mat4, glUniformMatrix4fv, value_ptr)
-        template<int count>
-        void bind(Uniform<GLSLUniformUnit::mat4, count> member, const string& name, const mat4& uniform) {
-            const auto location = glGetUniformLocation(program, name.data());
-            glUniformMatrix4fv(location, count, GL_FALSE, value_ptr(uniform));
-        }
-
-        #define DEFINE_ATTRIBUTE_BIND(unit, value_unit, unit_length) \
-        template<bool instanced> \
-        void bind(Attribute<GLSLUnit::unit, instanced> member, const string& name, const vector<value_unit> attribute_array) { \
-            const GLint location = glGetAttribLocation((GLuint)program, (GLchar*)name.data()); \
-            GLuint vertex_buffer; \
-            glGenBuffers(1, &vertex_buffer); \
-            glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer); \
-            glBufferData(GL_ARRAY_BUFFER, attribute_array.size() * sizeof(value_unit), &attribute_array[0], GL_STATIC_DRAW); \
-            glEnableVertexAttribArray(location); \
-            glVertexAttribPointer(location, unit_length, GL_FLOAT, GL_FALSE, \
-                sizeof(attribute_array[0]), (void*)nullptr); \
-        }
-        DEFINE_ATTRIBUTE_BIND(single, float, 1)
-        DEFINE_ATTRIBUTE_BIND(vec2, vec2, 2)
-        DEFINE_ATTRIBUTE_BIND(vec3, vec3, 3)
-        DEFINE_ATTRIBUTE_BIND(vec4, vec4, 4)
+        template<class Member> requires is_base_of_v<Uniform<GLSLUniformUnit::mat4, Member::element_count>, Member>
+        void bind(Member member, const mat4& uniform) {
+            if (gl::state.uniform_changed(location<Member>(), &uniform, sizeof(uniform))) {
+                glUniformMatrix4fv(location<Member>(), Member::element_count, GL_FALSE, value_ptr(uniform));
+            }
+        }
+
+        #define DEFINE_ATTRIBUTE_BIND(unit, value_unit) \
+        template<class Member> requires is_base_of_v<Attribute<GLSLUnit::unit, Member::is_instanced>, Member> \
+        void bind(Member member, span<const value_unit> attribute_array) { \
+            auto& buffer = buffers[member_index<Member>]; \
+            buffer.upload(as_bytes(attribute_array)); \
+            bind(member, buffer, sizeof(attribute_array[0])); \
+        }
+        DEFINE_ATTRIBUTE_BIND(single, float)
+        DEFINE_ATTRIBUTE_BIND(vec2, vec2)
+        DEFINE_ATTRIBUTE_BIND(vec3, vec3)
+        DEFINE_ATTRIBUTE_BIND(vec4, vec4)
+
+        /**
+         * 🧱 Feed an attribute straight from an entity store column, no repacking.
+         * `field` picks the part of each component to read, so Physics::position
+         * becomes a vec2 attribute with Physics' stride.
+         */
+        template<class Member, class Component, class Field>
+        requires is_base_of_v<Attribute<Member::glsl_unit, Member::is_instanced>, Member>
+        void bind(Member member, span<const Component> column, Field Component::* field) {
+            static_assert(sizeof(Field) == unit_length(Member::glsl_unit) * sizeof(float),
+                          "field doesn't match the attribute's GLSL type");
+            const Component sample{};
+            const auto offset = reinterpret_cast<const byte*>(&(sample.*field)) - reinterpret_cast<const byte*>(&sample);
+            auto& buffer = buffers[member_index<Member>];
+            buffer.upload(as_bytes(column));
+            bind(member, buffer, sizeof(Component), uintptr_t(offset));
+        }
 
         /**
-         * 📝 Write out the GLSL instructions to initialize members of
-         * the shader in the vertex shader
+         * 🔌 Read an attribute from a buffer uploaded elsewhere, e.g. a mesh shared between shaders.
+         * Only records the source, bind_vertex_array() turns the sources into GL state.
          */
-        void vertex_header(ostream& stream) {
-            std::apply([&stream](auto&... args){
-                ((vert_text(stream, args, get_class_name(args))), ...);
-            }, this->members.components);
+        template<class Member>
+        requires is_base_of_v<Attribute<Member::glsl_unit, Member::is_instanced>, Member>
+        void bind(Member member, const gl::AttributeBuffer& buffer, GLsizei stride, uintptr_t offset = 0) {
+            sources[member_index<Member>] = gl::AttributeSource{
+                buffer.id(), buffer.serial(), location<Member>(), GLint(unit_length(Member::glsl_unit)),
+                stride, offset, Member::is_instanced ? 1u : 0u,
+            };
         }
 
         /**
-         * 📝 Write out the GLSL instructions to initialize members of
-         * the shader in the vertex shader
+         * 🗃 Bind the VAO for the attribute sources set so far, building it the first time.
+         * Call after the attribute binds and before drawing.
          */
-        void fragment_header(ostream& stream) {
+        void bind_vertex_array() {
+            gl::state.bind_vertex_array(vertex_arrays.get(sources));
         }
     };
 
 
+    /**
+     * 🖼 Uniforms shared by every program, uploaded once per frame
+     */
+    struct FrameUniforms {
+        mat4 model_view_projection;
+    };
+}
+
+template<>
+struct hyp::gl::BlockSchema<ShaderBuilder::FrameUniforms>
+{
+    static constexpr std::array fields {
+        HYPER_BLOCK_FIELD(ShaderBuilder::FrameUniforms, model_view_projection),
+    };
+};
+
+namespace ShaderBuilder {
+
+    /**
+     * 🎬 Sprites bouncing over the world, shared by the window loop and the headless benchmark.
+     * Everything GL lives in here, so it is all released while the context still exists.
+     */
+    class SpriteScene {
+    public:
+        class vert_color : public Attribute<GLSLUnit::vec3, false> {};
+        class vert_position : public Attribute<GLSLUnit::vec2, false> {};
+        class extra_data : public Attribute<GLSLUnit::vec4, false> {};
+        class instance_offset : public Attribute<GLSLUnit::vec2, true> {};
+        class frame : public UniformBlock<FrameUniforms, 0> {};
+
+        using SpriteShader = Shader<vert_color, vert_position, extra_data, instance_offset, frame>;
+
+        struct SpriteInputs {
+            SpriteShader* shader = nullptr;
+            span<const vec2> offsets{};
+            // When set, offsets are read straight out of the Physics column instead
+            span<const Physics> bodies{};
+        };
+
+        /**
+         * 📸 What rendering needs from one simulation step, positions before and after it
+         * and the draws recorded for it
+         */
+        struct SpriteSnapshot {
+            vector<vec2> previous;
+            vector<vec2> current;
+            gl::CommandBuffer commands;
+            chrono::steady_clock::time_point published;
+        };
+
+        // One simulation step, the window loop runs them at this rate on their own thread
+        static constexpr chrono::nanoseconds tick_length{ 1'000'000'000 / 60 };
+
+        static inline const array<vec2, 3> triangle_positions{
+            vec2{ -0.6f, -0.4f },
+            vec2{  0.6f, -0.4f },
+            vec2{   0.f,  0.6f },
+        };
+        static inline const array<vec3, 3> triangle_colors{
+            vec3{1.f, 1.f, 0.f},
+            vec3{0.f, 1.f, 1.f},
+            vec3{1.f, 0.f, 1.f},
+        };
+
+        // 🏭 Shaders build while the scene loads, finish() only waits if the driver isn't done yet
+        gl::ShaderBuildQueue shader_builds;
+        SpriteShader shader;
+        Store<Archetype<Physics, Health>> sprites;
+        Archetype<World::Structure> world;
+        // 📣 Structural changes and reloads go through here, so whoever cares hears about them once a tick
+        ChangeTracker<Archetype<World::Structure>> world_changes{ world };
+        hyper::HotReload<World::Structure> world_reload{ World::save_path, "structures" };
+        gl::RenderQueue queue;
+        gl::UniformRing<FrameUniforms> frame_uniforms{ frame::binding };
+        SpriteInputs inputs{ &shader };
+        // 🔺 Simulation hands snapshots to rendering here, the only state both sides touch
+        TripleBuffer<SpriteSnapshot> snapshots;
+        // Simulation side: positions from the last published step
+        vector<vec2> last_positions;
+        // Render side: the snapshot blended to the current frame's time
+        vector<vec2> interpolated;
+        // 🕸 One simulation step, run across the pool
+        FrameGraph systems;
+
+        explicit SpriteScene(size_t sprite_count = 10000) :
+            shader{
+                R"glsl(
+                    varying vec3 frag_color;
+
+                    void main()
+                    {
+                        gl_Position = model_view_projection * vec4(vert_position * 0.05 + instance_offset, 0.0, 1.0);
+                        frag_color = vert_color * (sin(extra_data.x * 10.0) + 1.0);
+                    }
+
+                )glsl",
+                R"glsl(
+                    varying vec3 frag_color;
+
+                    void main()
+                    {
+                        gl_FragColor = vec4(frag_color, 1.0);
+                    }
+
+                )glsl",
+                Entity{ vert_color{}, vert_position{}, extra_data{}, instance_offset{}, frame{} },
+                shader_builds
+            } {
+            // 🚀 Every sprite is one instance on a square grid
+            const auto side = size_t(ceil(sqrt(double(sprite_count))));
+            const float half = float(side) / 2.0f;
+            sprites.archetype<Physics, Health>().reserve(sprite_count);
+            for (size_t i = 0; i < sprite_count; ++i) {
+                const float x = float(i % side);
+                const float y = float(i / side);
+                sprites.add(Physics{
+                    vec2{ x / half - 1.0f, y / half - 1.0f },
+                    vec2{ (x - half) / (half * 100.0f), (y - half) / (half * 100.0f) },
+                }, Health{ 100, 100 });
+            }
+
+            // 🌍 Static world data, replaced by the editor's save if there is one and kept in sync with it
+            world_changes.add_many(std::span<const World::Structure>{ World::data });
+            if (filesystem::exists(World::save_path)) {
+                world_reload.reload(world_changes);
+            }
+            world_changes.publish();
+            world_changes.subscribe<World::Structure>([](span<const size_t> rows, span<const World::Structure>) {
+                cout << "world: " << rows.size() << " structures changed" << endl;
+            });
+
+            // Every program of the scene went into shader_builds and compiled while the data above loaded
+            shader_builds.finish_all();
+            shader.finish(shader_builds);
+            // ⏱ Cold start compiles, warm start should only load from the program cache
+            cout << gl::shader_stats << endl;
+
+            last_positions.reserve(sprite_count);
+            interpolated.reserve(sprite_count);
+            snapshots.for_each_slot([sprite_count](SpriteSnapshot& snapshot) {
+                snapshot.previous.reserve(sprite_count);
+                snapshot.current.reserve(sprite_count);
+                // The arena keeps its block across resets, so the slot first recorded on the third tick doesn't allocate then
+                snapshot.commands.packets.reserve(1);
+            });
+
+            // The world reload touches no sprite data, so it overlaps with the whole sprite chain.
+            // Snapshot and record only read what physics and health left behind, so they overlap with each other.
+            systems.add("world reload", Reads<>{}, Writes<World::Structure>{}, [this] {
+                world_reload.poll(world_changes);
+                world_changes.publish();
+            });
+            systems.add("physics", Reads<>{}, Writes<Physics>{}, [this] {
+                integrate_physics(sprites, ThreadPool::shared(), 1.0f);
+                sprites.view<Physics>().par_each([](Physics& sprite) {
+                    const auto wrap = [](float value) {
+                        return value > 1.0f ? value - 2.0f : value < -1.0f ? value + 2.0f : value;
+                    };
+                    sprite.position = vec2{ wrap(sprite.position.x), wrap(sprite.position.y) };
+                });
+            });
+            // Culling the dead swaps rows around, so health writes Physics too
+            systems.add("health", Reads<>{}, Writes<Physics, Health>{}, [this] {
+                if (update_health(sprites) > 0) {
+                    // Rows moved, blending from the old positions would slide sprites across the screen
+                    last_positions.clear();
+                }
+            });
+            systems.add("snapshot", Reads<Physics>{}, Writes<>{}, [this] {
+                auto& snapshot = snapshots.back();
+                const auto bodies = sprites.archetype<Physics, Health>().column<Physics>();
+                snapshot.previous.assign(last_positions.begin(), last_positions.end());
+                snapshot.current.resize(bodies.size());
+                for (size_t i = 0; i < bodies.size(); ++i) {
+                    snapshot.current[i] = bodies[i].position;
+                }
+                last_positions.assign(snapshot.current.begin(), snapshot.current.end());
+            });
+            // Only records, the GL thread replays the packets once it picks the snapshot up
+            systems.add("record", Reads<Physics>{}, Writes<>{}, [this] {
+                auto& commands = snapshots.back().commands;
+                commands.reset();
+                commands.draw(gl::DrawPacket{
+                    shader.program,
+                    gl::Binding::of(inputs, [](const SpriteInputs& inputs) {
+                        inputs.shader->bind(vert_position{}, span<const vec2>{ triangle_positions });
+                        inputs.shader->bind(vert_color{}, span<const vec3>{ triangle_colors });
+                        if (!inputs.bodies.empty()) {
+                            inputs.shader->bind(instance_offset{}, inputs.bodies, &Physics::position);
+                        } else {
+                            inputs.shader->bind(instance_offset{}, inputs.offsets);
+                        }
+                        inputs.shader->bind_vertex_array();
+                    }),
+                    gl::Binding{},
+                    GL_TRIANGLES, 0, 3, GLsizei(sprites.archetype<Physics, Health>().size())
+                });
+            });
+        }
+
+        /**
+         * ⚙ Advance the simulation one tick and publish a snapshot. No GL, any one thread at a time.
+         */
+        void simulate() {
+            systems.run(ThreadPool::shared());
+            snapshots.back().published = chrono::steady_clock::now();
+            snapshots.publish();
+        }
+
+        /**
+         * 🎨 Draw the newest snapshot as it should look at `now`, blended from its previous positions
+         * by how far `now` is into the tick after it was published.
+         * GL thread only, presenting is up to the caller.
+         */
+        gl::RenderStats render(chrono::steady_clock::time_point now) {
+            // One update per frame, the blend has to come from the snapshot that gets drawn
+            snapshots.update();
+            const chrono::duration<float> since = now - snapshots.front().published;
+            return draw(std::clamp(since / chrono::duration<float>{ tick_length }, 0.0f, 1.0f));
+        }
+
+        /**
+         * 🎞 Simulate and draw in lockstep, one tick per frame.
+         * Nothing is simulating meanwhile and there is nothing to blend, so the instances
+         * come straight from the Physics column without a copy.
+         */
+        gl::RenderStats step() {
+            simulate();
+            snapshots.update();
+            gl::buffer_stats.begin_frame();
+            inputs.bodies = sprites.archetype<Physics, Health>().column<Physics>();
+            return replay();
+        }
+
+    private:
+        /**
+         * Draw the front snapshot, `blend` of the way from its previous positions to its current ones
+         */
+        gl::RenderStats draw(float blend) {
+            gl::buffer_stats.begin_frame();
+            const auto& snapshot = snapshots.front();
+            inputs.bodies = {};
+            interpolated.resize(snapshot.current.size());
+            for (size_t i = 0; i < snapshot.current.size(); ++i) {
+                const vec2 current = snapshot.current[i];
+                const vec2 previous = i < snapshot.previous.size() ? snapshot.previous[i] : current;
+                // A sprite that wrapped around the edge jumps instead of sliding across the screen
+                const bool wrapped = abs(current.x - previous.x) > 1.0f || abs(current.y - previous.y) > 1.0f;
+                interpolated[i] = wrapped ? current : mix(previous, current, blend);
+            }
+
+            inputs.offsets = interpolated;
+            return replay();
+        }
+
+        /**
+         * Replay the draws recorded for the front snapshot with the current inputs.
+         * The queue sorts the frame's draws and only rebinds what changed.
+         */
+        gl::RenderStats replay() {
+            auto& commands = queue.record();
+            for (const auto& packet : snapshots.front().commands.packets) {
+                commands.draw(packet);
+            }
+            frame_uniforms.upload(FrameUniforms{ mat4{ 1.0f } });
+            return queue.submit();
+        }
+    };
+
+    /**
+     * 🪟 Simulation ticks at a fixed rate on its own thread, so a slow frame or vsync wait
+     * never holds it back, and the window draws whatever it published last
+     */
+    void run_scene(GLFWwindow* window) {
+        SpriteScene scene;
+        const FixedStepThread simulation{ SpriteScene::tick_length, [&scene] { scene.simulate(); } };
+        while (!glfwWindowShouldClose(window))
+        {
+            scene.render(chrono::steady_clock::now());
+
+            glfwSwapBuffers(window);
+
+            glfwPollEvents();
+        }
+    }
+
     // 👨‍🔬
     void test() {
         if (!glfwInit())
@@ -385,62 +800,90 @@ namespace ShaderBuilder {
         });
 
         glfwSwapInterval(1);
-        
-        class vert_color : public Attribute<GLSLUnit::vec3, false> {};
-        class vert_position : public Attribute<GLSLUnit::vec2, false> {};
-        class extra_data : public Attribute<GLSLUnit::vec4, false> {};
-        class model_view_projection : public Uniform<GLSLUniformUnit::mat4, 1> {};
 
-        auto shader = Shader{
-            R"glsl(
-                varying vec3 frag_color;
-
-                void main()
-                {
-                    gl_Position = model_view_projection * vec4(vert_position, 0.0, 1.0);
-                    frag_color = vert_color * (sin(extra_data.x * 10.0) + 1.0);
-                }
+        run_scene(window);
 
-            )glsl",
-            R"glsl(
-                varying vec3 frag_color;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
 
-                void main()
-                {
-                    gl_FragColor = vec4(frag_color, 1.0);
-                }
+    struct BenchmarkOptions {
+        size_t frames = 500;
+        size_t entities = 10000;
+        int width = 640;
+        int height = 480;
+        // Fail if a steady-state frame makes more GL calls than this, allocates or queries locations. 0 = off
+        size_t gl_budget = 0;
+    };
 
-            )glsl",
-            Entity{ vert_color{}, vert_position{}, extra_data{}, model_view_projection() }
-        };
+    /**
+     * 🏁 Render `frames` frames offscreen with no vsync and print the frame time
+     * distribution, draw calls, buffer uploads and GL call counts as JSON
+     */
+    int benchmark(const BenchmarkOptions& options) {
+        using clock = chrono::steady_clock;
+        // Frames before this one may still be creating buffers and growing queues
+        constexpr size_t warm_up_frames = 2;
+
+        const auto context = gl::HeadlessContext{ options.width, options.height };
+        if (!context) {
+            return 1;
+        }
+        gl::Recorder recorder;
 
-        while (!glfwWindowShouldClose(window))
+        bench::FrameReport report;
+        report.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        report.entities = options.entities;
+        report.reserve(options.frames);
+        size_t over_budget = 0;
         {
-            glUseProgram(shader.program);
-
-            shader.bind(model_view_projection{}, "model_view_projection", mat4{ 1.0f });
-
-            shader.bind(vert_position{}, "vert_position", {
-                vec2{ -0.6f, -0.4f },
-                vec2{  0.6f, -0.4f },
-                vec2{   0.f,  0.6f },
-            });
-
-            shader.bind(vert_color{}, "vert_color", {
-                vec3{1.f, 1.f, 0.f},
-                vec3{0.f, 1.f, 1.f},
-                vec3{1.f, 0.f, 1.f},
-            });
-            glDrawArrays(GL_TRIANGLES, 0, 3);
-
-            glfwSwapBuffers(window);
-
-            glfwPollEvents();
+            SpriteScene scene{ options.entities };
+            for (size_t frame = 0; frame < options.frames; ++frame) {
+                recorder.begin_frame();
+                gl::state.begin_frame();
+                const AllocationScope allocations;
+                const auto start = clock::now();
+                glClear(GL_COLOR_BUFFER_BIT);
+                const auto stats = scene.step();
+                const auto submitted = clock::now();
+                glFinish();
+                const auto finished = clock::now();
+
+                const auto& calls = recorder.frame();
+                const auto sample = bench::FrameSample{
+                    chrono::duration<double, milli>(submitted - start).count(),
+                    chrono::duration<double, milli>(finished - start).count(),
+                    stats.draw_calls,
+                    gl::buffer_stats.frame.uploads,
+                    gl::buffer_stats.frame.bytes_uploaded,
+                    calls.calls,
+                    calls.redundant_use_program + calls.redundant_bind_buffer,
+                    calls.location_queries,
+                    allocations.count(),
+                    allocations.bytes(),
+                    stats.arena_bytes,
+                    gl::state.frame.eliminated,
+                };
+                report.add(sample);
+
+                if (options.gl_budget && frame >= warm_up_frames &&
+                    (sample.gl_calls > options.gl_budget || sample.allocations || sample.location_queries)) {
+                    if (over_budget++ == 0) {
+                        cerr << "frame " << frame << " over budget: " << calls << ", "
+                             << sample.allocations << " allocations (" << sample.heap_bytes << " bytes)" << endl;
+                    }
+                }
+            }
         }
-        glfwDestroyWindow(window);
-        glfwTerminate();
-
-        // shader.render(lister);
+        report.write_json(cout);
+        if (options.gl_budget && !AllocationCounter::enabled) {
+            cerr << "allocation counting isn't compiled in, only GL calls were checked" << endl;
+        }
+        if (over_budget) {
+            cerr << over_budget << " frames over the budget of " << options.gl_budget << " GL calls" << endl;
+            return 3;
+        }
+        return 0;
     }
 
     // 🔍 Output state of tuple
@@ -464,9 +907,31 @@ namespace ShaderBuilder {
 // <- 😎
             
 
-int main()
+int main(int argc, char** argv)
 {
+    // 🕶 --headless [--frames N] [--entities N] [--gl-budget N] runs the frame benchmark instead of the game
+    if (argc > 1 && std::string_view{ argv[1] } == "--headless") {
+        ShaderBuilder::BenchmarkOptions options;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            const std::string_view flag = argv[i];
+            const auto value = std::strtoull(argv[i + 1], nullptr, 10);
+            if (flag == "--frames") {
+                options.frames = value;
+            } else if (flag == "--entities") {
+                options.entities = value;
+            } else if (flag == "--gl-budget") {
+                options.gl_budget = value;
+            } else {
+                std::cerr << "unknown option " << flag << std::endl;
+                return 2;
+            }
+        }
+        return ShaderBuilder::benchmark(options);
+    }
+
     hyp::test();
+    hyp::test_archetypes();
+    hyp::test_change_tracker();
 
 	std::cout << "Hey ho! my Worldlings!" << std::endl;
 
@@ -474,4 +939,4 @@ int main()
     ShaderBuilder::test();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -4,9 +4,14 @@
 
 #include <rxcpp/rx.hpp>
 #include <random>
-#include <regex>
+#include <span>
+#include <string_view>
 #include <glm/vec2.hpp>
 
+#include "archetype.hpp"
+#include "change_tracker.hpp"
+#include "line_framer.hpp"
+
 namespace Rx {
     using namespace rxcpp;
     using namespace rxcpp::sources;
@@ -20,15 +25,13 @@ namespace Std {
     using namespace std::chrono;
 }
 
-class Enemy {
-    public:
-        const rxcpp::subjects::detail::behavior_observer<glm::vec2> position;
-
-        Enemy(glm::vec2 starting_position) :
-                position(starting_position, { }) {
-        }
+// 👾 Enemies are rows, observers get every tick's moves in one batch instead of a subject per enemy
+struct EnemyPosition {
+    glm::vec2 value;
 };
 
+using Enemies = hyp::Archetype<EnemyPosition>;
+
 int main() {
     Std::random_device rd;   // non-deterministic generator
     Std::mt19937 gen(rd());
@@ -63,49 +66,33 @@ int main() {
     //
     // recover lines of text from byte stream
     //
-    
-    auto removespaces = [](Std::string s){
-        s.erase(Std::remove_if(s.begin(), s.end(), ::isspace), s.end());
-        return s;
-    };
-
-    // create strings split on \r
-    auto strings = bytes |
-        Rx::concat_map([](Std::vector<uint8_t> v){
-            Std::string s(v.begin(), v.end());
-            Std::regex delim(R"/(\r)/");
-            Std::cregex_token_iterator cursor(&s[0], &s[0] + s.size(), delim, {-1, 0});
-            Std::cregex_token_iterator end;
-            Std::vector<Std::string> splits(cursor, end);
-            return Rx::iterate(move(splits));
-        }) |
-        Rx::filter([](const Std::string& s){
-            return !s.empty();
-        }) |
-        Rx::publish() |
-        Rx::ref_count();
-
-    // filter to last string in each line
-    auto closes = strings |
-        Rx::filter(
-            [](const Std::string& s){
-                return s.back() == '\r';
-            }) |
-        Rx::map([](const Std::string&){return 0;});
 
-    // group strings by line
-    auto linewindows = strings |
-        Rx::window_toggle(closes | Rx::start_with(0), [=](int){return closes;});
-
-    // reduce the strings for a line into one string
-    auto lines = linewindows |
-        Rx::flat_map([&](Rx::observable<Std::string> w) {
-            return w | Rx::start_with<Std::string>("") | Rx::sum() | Rx::map(removespaces);
+    // lines are cut straight out of each packet, only a line split across packets is copied
+    hyp::LineFramer framer{'\r'};
+    bytes |
+        Rx::subscribe<Std::vector<uint8_t>>([&framer](const Std::vector<uint8_t>& packet){
+            framer.push(Std::span<const uint8_t>{packet}, [](Std::string_view line){
+                Std::cout << line << Std::endl;
+            });
         });
 
-    // print result
-    lines |
-        Rx::subscribe<Std::string>(Rx::println(Std::cout));
+    Enemies enemies;
+    hyp::ChangeTracker<Enemies> enemy_changes{enemies};
+    enemy_changes.subscribe<EnemyPosition>([](Std::span<const Std::size_t> rows, Std::span<const EnemyPosition> positions) {
+        for (const auto row : rows) {
+            Std::cout << "enemy " << row << " at " << positions[row].value.x << ", " << positions[row].value.y << Std::endl;
+        }
+    });
+    for (int i = 0; i < 8; ++i) {
+        enemy_changes.add(EnemyPosition{glm::vec2{float(i), 0.0f}});
+    }
+    enemy_changes.publish();
+    // Every other enemy steps forward, one batch for all of them
+    for (Std::size_t row = 0; row < enemies.size(); row += 2) {
+        enemies.column<EnemyPosition>()[row].value.y += 1.0f;
+        enemy_changes.mark<EnemyPosition>(row);
+    }
+    enemy_changes.publish();
 
     Std::cout <<("Hey I'm done!") << Std::endl;
     return 0;
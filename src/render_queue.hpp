@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "frame_arena.hpp"
+#include "gl_state.hpp"
+#include "thread_pool.hpp"
+
+namespace hyp::gl {
+
+    /**
+     * 🔗 A piece of GL state a packet needs, applied by calling apply(state).
+     * Packets sharing the same state pointer are bound once for the whole run.
+     */
+    struct Binding {
+        const void* state = nullptr;
+        void (*apply)(const void* state) = nullptr;
+
+        /**
+         * Wrap a captureless lambda taking const State&
+         */
+        template<typename State, typename Apply>
+        static Binding of(const State& state, Apply) {
+            return {&state, [](const void* erased) {
+                Apply{}(*static_cast<const State*>(erased));
+            }};
+        }
+
+        bool operator==(const Binding& other) const {
+            return state == other.state && apply == other.apply;
+        }
+    };
+
+    /**
+     * 🎨 One draw call with everything needed to replay it later
+     */
+    struct DrawPacket {
+        GLuint program = 0;
+        Binding buffers;
+        Binding uniforms;
+        GLenum mode = GL_TRIANGLES;
+        GLint first = 0;
+        GLsizei count = 0;
+        GLsizei instances = 1;
+    };
+
+    /**
+     * 🔑 program | buffers | uniforms, most expensive switch in the top bits so sorting
+     * groups by program first. Bindings only contribute a hash, a collision just costs a rebind.
+     */
+    inline std::uint64_t sort_key(const DrawPacket& packet) {
+        const auto hash24 = [](const void* pointer) {
+            const auto value = reinterpret_cast<std::uintptr_t>(pointer);
+            return std::uint64_t(value) * 0x9E3779B97F4A7C15ull >> 40;
+        };
+        return (std::uint64_t(packet.program & 0xFFFF) << 48) |
+               (hash24(packet.buffers.state) << 24) |
+               hash24(packet.uniforms.state);
+    }
+
+    /**
+     * 📝 One thread's packets for the current frame, kept in that thread's own arena.
+     * Recording threads write neighbouring buffers at once, each gets its own cache line.
+     */
+    class alignas(64) CommandBuffer {
+    public:
+        FrameArena arena;
+        std::pmr::vector<DrawPacket> packets{&arena};
+
+        CommandBuffer() = default;
+
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        void draw(const DrawPacket& packet) {
+            packets.push_back(packet);
+        }
+
+        /**
+         * Drop the packets and hand their memory back to the arena for the next frame
+         */
+        void reset() {
+            std::pmr::vector<DrawPacket>{&arena}.swap(packets);
+            arena.reset();
+        }
+    };
+
+    struct RenderStats {
+        std::size_t draw_calls = 0;
+        std::size_t program_binds = 0;
+        std::size_t buffer_binds = 0;
+        std::size_t uniform_binds = 0;
+        // Transient memory the frame took from the queue's arenas, and how often they had to grow
+        std::size_t arena_bytes = 0;
+        std::size_t arena_growths = 0;
+    };
+
+    /**
+     * 📬 Collects draw packets from any thread, then sorts and replays them on the GL thread.
+     * Every thread records into its own CommandBuffer (picked by thread_index()), so recording
+     * takes no locks; submit() merges them, radix sorts by key and only rebinds what changed.
+     * The sprite scene has a single producer: it replays one instanced packet per snapshot from
+     * the GL thread, so only that thread's buffer is ever filled today.
+     */
+    class RenderQueue {
+    public:
+        // thread_index() never reaches this, it hands indices back as threads exit
+        static constexpr std::size_t max_threads = max_thread_indices;
+
+        /**
+         * ✍ The calling thread's command buffer, only that thread may touch it until submit()
+         */
+        CommandBuffer& record() {
+            return buffers[thread_index()];
+        }
+
+        /**
+         * 🚚 Merge, sort and replay everything recorded since the last submit. GL thread only,
+         * and no recording may be in flight.
+         */
+        RenderStats submit() {
+            RenderStats stats;
+            std::size_t count = 0;
+            for (const auto& buffer : buffers) {
+                count += buffer.packets.size();
+            }
+            // Merged packets and sort keys only live until the replay is done
+            std::pmr::vector<DrawPacket> merged{&submit_arena};
+            std::pmr::vector<SortItem> items{&submit_arena};
+            merged.reserve(count);
+            items.reserve(count);
+            for (auto& buffer : buffers) {
+                for (const auto& packet : buffer.packets) {
+                    items.push_back({sort_key(packet), std::uint32_t(merged.size())});
+                    merged.push_back(packet);
+                }
+                add_arena_stats(stats, buffer.arena);
+                buffer.reset();
+            }
+            radix_sort(items);
+
+            GLuint program = 0;
+            Binding bound_buffers;
+            Binding bound_uniforms;
+            for (const auto& item : items) {
+                const DrawPacket& packet = merged[item.index];
+                if (packet.program != program || stats.draw_calls == 0) {
+                    state.use_program(packet.program);
+                    program = packet.program;
+                    bound_uniforms = {};
+                    ++stats.program_binds;
+                }
+                if (!(packet.buffers == bound_buffers)) {
+                    if (packet.buffers.apply) {
+                        packet.buffers.apply(packet.buffers.state);
+                    }
+                    bound_buffers = packet.buffers;
+                    ++stats.buffer_binds;
+                }
+                if (!(packet.uniforms == bound_uniforms)) {
+                    if (packet.uniforms.apply) {
+                        packet.uniforms.apply(packet.uniforms.state);
+                    }
+                    bound_uniforms = packet.uniforms;
+                    ++stats.uniform_binds;
+                }
+                if (packet.instances == 1) {
+                    glDrawArrays(packet.mode, packet.first, packet.count);
+                } else {
+                    glDrawArraysInstanced(packet.mode, packet.first, packet.count, packet.instances);
+                }
+                ++stats.draw_calls;
+            }
+            add_arena_stats(stats, submit_arena);
+            merged = std::pmr::vector<DrawPacket>{&submit_arena};
+            items = std::pmr::vector<SortItem>{&submit_arena};
+            submit_arena.reset();
+            last_stats = stats;
+            return stats;
+        }
+
+        const RenderStats& stats() const {
+            return last_stats;
+        }
+
+    private:
+        struct SortItem {
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+
+        std::array<CommandBuffer, max_threads> buffers;
+        // Merge and sort space for submit(), reset once the frame is replayed
+        FrameArena submit_arena;
+        RenderStats last_stats;
+
+        static void add_arena_stats(RenderStats& stats, const FrameArena& arena) {
+            stats.arena_bytes += arena.stats().bytes;
+            stats.arena_growths += arena.stats().upstream_allocations;
+        }
+
+        /**
+         * 🔀 LSD radix sort on the key a byte at a time, skipping bytes every key shares.
+         * Stable, so packets with equal keys replay in recording order.
+         */
+        void radix_sort(std::pmr::vector<SortItem>& items) {
+            std::pmr::vector<SortItem> scratch(items.size(), &submit_arena);
+            for (int shift = 0; shift < 64; shift += 8) {
+                std::array<std::size_t, 257> offsets{};
+                for (const auto& item : items) {
+                    ++offsets[((item.key >> shift) & 0xFF) + 1];
+                }
+                if (!items.empty() && offsets[((items[0].key >> shift) & 0xFF) + 1] == items.size()) {
+                    continue;
+                }
+                for (std::size_t digit = 1; digit < offsets.size(); ++digit) {
+                    offsets[digit] += offsets[digit - 1];
+                }
+                for (const auto& item : items) {
+                    scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+                }
+                items.swap(scratch);
+            }
+        }
+    };
+}
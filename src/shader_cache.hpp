@@ -0,0 +1,326 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "hash.hpp"
+
+namespace hyp::gl {
+
+    /**
+     * 📜 Source of one shader stage, handed to the driver as separate strings.
+     * Parts don't need to be null terminated, unused ones stay empty.
+     */
+    struct StageSource {
+        GLenum stage;
+        std::array<std::string_view, 3> parts;
+    };
+
+    /**
+     * ⏱ Where shader startup time goes - a warm cache should turn compiles into loads
+     */
+    struct ShaderStats {
+        std::size_t cache_hits = 0;
+        std::size_t cache_misses = 0;
+        std::size_t cache_rejected = 0;
+        double compile_ms = 0;
+        double load_ms = 0;
+    };
+
+    inline ShaderStats shader_stats;
+
+    inline std::ostream& operator<<(std::ostream& stream, const ShaderStats& stats) {
+        return stream << "shaders: " << stats.cache_hits << " cached in " << stats.load_ms << " ms, "
+                      << stats.cache_misses << " compiled in " << stats.compile_ms << " ms"
+                      << (stats.cache_rejected ? " (" + std::to_string(stats.cache_rejected) + " stale)" : "");
+    }
+
+    /**
+     * 🔑 Hash of every source part plus the driver identity, a new driver invalidates the cache
+     */
+    inline std::uint64_t program_key(std::span<const StageSource> stages) {
+        std::uint64_t hash = hash_bytes({});
+        const auto mix = [&hash](std::string_view text) {
+            hash = hash_bytes(std::as_bytes(std::span{text}), hash);
+            hash = hash_bytes(std::as_bytes(std::span{"\0", 1}), hash);
+        };
+        for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const auto* text = reinterpret_cast<const char*>(glGetString(name));
+            mix(text ? text : "");
+        }
+        for (const auto& stage : stages) {
+            hash = hash_bytes(std::as_bytes(std::span{&stage.stage, 1}), hash);
+            for (const auto part : stage.parts) {
+                mix(part);
+            }
+        }
+        return hash;
+    }
+
+    /**
+     * 💾 Linked program binaries on disk, one file per program_key.
+     * Only active when the driver can hand out binaries (GL 4.1 or ARB_get_program_binary
+     * with at least one format); otherwise every lookup is a miss and nothing is written.
+     */
+    class ProgramCache {
+    public:
+        explicit ProgramCache(std::filesystem::path directory = "shader_cache") :
+            directory{std::move(directory)} {
+        }
+
+        bool available() const {
+            if (!(GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary)) {
+                return false;
+            }
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            return formats > 0;
+        }
+
+        /**
+         * 📤 Load the binary for `key` into `program`, false on a miss or if the driver refuses it
+         */
+        bool load(GLuint program, std::uint64_t key) const {
+            if (!available()) {
+                return false;
+            }
+            std::ifstream stream{path_of(key), std::ios::binary};
+            GLenum format = 0;
+            if (!stream.read(reinterpret_cast<char*>(&format), sizeof(format))) {
+                return false;
+            }
+            const std::vector<char> binary{std::istreambuf_iterator<char>{stream}, {}};
+            glProgramBinary(program, format, binary.data(), GLsizei(binary.size()));
+
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (linked != GL_TRUE) {
+                ++shader_stats.cache_rejected;
+                std::error_code error;
+                std::filesystem::remove(path_of(key), error);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * 📥 Save the linked `program` under `key`, link it with prepare() first
+         */
+        void store(GLuint program, std::uint64_t key) const {
+            if (!available()) {
+                return;
+            }
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0) {
+                return;
+            }
+            std::vector<char> binary(static_cast<std::size_t>(length));
+            GLenum format = 0;
+            glGetProgramBinary(program, length, &length, &format, binary.data());
+
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            std::ofstream stream{path_of(key), std::ios::binary};
+            stream.write(reinterpret_cast<const char*>(&format), sizeof(format));
+            stream.write(binary.data(), length);
+            if (!stream) {
+                std::cerr << "shader cache: couldn't write " << path_of(key) << std::endl;
+            }
+        }
+
+        /**
+         * Ask the driver to keep the binary retrievable, call before linking
+         */
+        void prepare(GLuint program) const {
+            if (available()) {
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+        }
+
+        static ProgramCache& shared() {
+            static ProgramCache cache;
+            return cache;
+        }
+
+    private:
+        const std::filesystem::path directory;
+
+        std::filesystem::path path_of(std::uint64_t key) const {
+            char name[24];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+            return directory / name;
+        }
+    };
+
+    /**
+     * ⚙ Start compiling one stage, check_stage() reads the result
+     */
+    inline GLuint compile_stage(const StageSource& source) {
+        std::array<const GLchar*, 3> strings{};
+        std::array<GLint, 3> lengths{};
+        GLsizei count = 0;
+        for (const auto part : source.parts) {
+            // Unused parts are null views, which drivers won't take even at length 0
+            if (!part.empty()) {
+                strings[count] = part.data();
+                lengths[count++] = GLint(part.size());
+            }
+        }
+        const GLuint shader = glCreateShader(source.stage);
+        glShaderSource(shader, count, strings.data(), lengths.data());
+        glCompileShader(shader);
+        return shader;
+    }
+
+    inline bool check_stage(GLuint shader) {
+        GLint compiled;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (compiled != GL_TRUE) {
+            GLsizei length;
+            GLchar log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), &length, log);
+            GLint stage;
+            glGetShaderiv(shader, GL_SHADER_TYPE, &stage);
+            std::cerr << (stage == GL_VERTEX_SHADER ? "vertex_shader: " : "fragment_shader: ")
+                      << std::endl << log << std::endl;
+        }
+        return compiled == GL_TRUE;
+    }
+
+    inline bool check_program(GLuint program) {
+        GLint linked;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            GLsizei length;
+            GLchar log[1024];
+            glGetProgramInfoLog(program, sizeof(log), &length, log);
+            std::cerr << "program: " << std::endl << log << std::endl;
+        }
+        return linked == GL_TRUE;
+    }
+
+    /**
+     * 🎫 Ticket for a program handed to ShaderBuildQueue::submit()
+     */
+    struct ProgramBuild {
+        std::size_t slot = ~std::size_t{0};
+    };
+
+    /**
+     * 🏭 Starts every compile and link up front and only asks for results when they are needed.
+     * Status queries are what make the driver wait, so nothing here queries until finish().
+     * Submit every program of a loading phase, do the phase's other work, then finish_all():
+     * with KHR/ARB_parallel_shader_compile the driver compiles on its own threads meanwhile,
+     * without it compiles still queue up behind each other instead of stalling one by one.
+     * Slots aren't reused, use one queue per loading phase.
+     */
+    class ShaderBuildQueue {
+    public:
+        explicit ShaderBuildQueue(ProgramCache& cache = ProgramCache::shared()) :
+            cache{cache} {
+            if (GLAD_GL_KHR_parallel_shader_compile) {
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            } else if (GLAD_GL_ARB_parallel_shader_compile) {
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+            }
+        }
+
+        /**
+         * 🏗 Fill `program` from the cache, or start compiling and linking `stages`
+         */
+        ProgramBuild submit(GLuint program, std::span<const StageSource> stages) {
+            const auto start = clock::now();
+            Pending build{program, program_key(stages)};
+            if (cache.load(program, build.key)) {
+                build.done = build.built = true;
+                ++shader_stats.cache_hits;
+                shader_stats.load_ms += elapsed_ms(start);
+            } else {
+                assert(stages.size() <= build.shaders.size());
+                for (const auto& stage : stages) {
+                    build.shaders[build.shader_count] = compile_stage(stage);
+                    glAttachShader(program, build.shaders[build.shader_count++]);
+                }
+                cache.prepare(program);
+                glLinkProgram(program);
+                ++shader_stats.cache_misses;
+                shader_stats.compile_ms += elapsed_ms(start);
+            }
+            builds.push_back(build);
+            return {builds.size() - 1};
+        }
+
+        /**
+         * ⏳ Wait for the program, report errors and cache it. Returns whether it linked.
+         */
+        bool finish(ProgramBuild handle) {
+            Pending& build = builds[handle.slot];
+            if (build.done) {
+                return build.built;
+            }
+            const auto start = clock::now();
+            build.built = true;
+            for (std::size_t i = 0; i < build.shader_count; ++i) {
+                build.built &= check_stage(build.shaders[i]);
+                glDetachShader(build.program, build.shaders[i]);
+                glDeleteShader(build.shaders[i]);
+            }
+            build.built &= check_program(build.program);
+            if (build.built) {
+                cache.store(build.program, build.key);
+            }
+            build.done = true;
+            shader_stats.compile_ms += elapsed_ms(start);
+            return build.built;
+        }
+
+        /**
+         * ⏳ finish() every build submitted so far, in submission order
+         */
+        void finish_all() {
+            for (std::size_t slot = 0; slot < builds.size(); ++slot) {
+                finish({slot});
+            }
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct Pending {
+            GLuint program;
+            std::uint64_t key;
+            std::array<GLuint, 4> shaders{};
+            std::size_t shader_count = 0;
+            bool done = false;
+            bool built = false;
+        };
+
+        ProgramCache& cache;
+        std::vector<Pending> builds;
+
+        static double elapsed_ms(clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        }
+    };
+
+    /**
+     * 🏗 Fill `program` from the cache, or compile and link `stages` and cache the result, blocking
+     */
+    inline bool build_program(GLuint program, std::span<const StageSource> stages, ProgramCache& cache = ProgramCache::shared()) {
+        ShaderBuildQueue queue{cache};
+        return queue.finish(queue.submit(program, stages));
+    }
+}
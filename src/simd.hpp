@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HYP_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC lets any function use AVX2 intrinsics, GCC/Clang need it opted in per function
+#if defined(HYP_SIMD_X86) && !defined(_MSC_VER)
+#define HYP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HYP_TARGET_AVX2
+#endif
+
+#include "entity.hpp"
+
+namespace hyp::simd {
+
+    enum class Level {
+        scalar,
+        sse2,
+        avx2,
+    };
+
+    inline const char* to_string(Level level) {
+        switch (level) {
+            case Level::scalar: return "scalar";
+            case Level::sse2: return "sse2";
+            case Level::avx2: return "avx2";
+        }
+        return "unknown";
+    }
+
+    /**
+     * 🔎 Widest instruction set this CPU (and OS) can run, checked once
+     */
+    inline Level detect() {
+        static const Level level = [] {
+#if defined(HYP_SIMD_X86) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+            const bool avx = info[2] & (1 << 28);
+            __cpuidex(info, 7, 0);
+            const bool avx2 = info[1] & (1 << 5);
+            return os_saves_ymm && avx && avx2 ? Level::avx2 : Level::sse2;
+#elif defined(HYP_SIMD_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return Level::avx2;
+            }
+            return __builtin_cpu_supports("sse2") ? Level::sse2 : Level::scalar;
+#else
+            return Level::scalar;
+#endif
+        }();
+        return level;
+    }
+
+    // 🐢 Scalar kernels, also used for the tails of the vector ones
+
+    inline void scaled_add_scalar(float* out, const float* in, std::size_t count, float scale) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] += in[i] * scale;
+        }
+    }
+
+    inline void integrate_scalar(Physics* physics, std::size_t count, float dt) {
+        for (std::size_t i = 0; i < count; ++i) {
+            physics[i].position += physics[i].velocity * dt;
+        }
+    }
+
+    inline void clamp_health_scalar(Health* health, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            health[i].current = health[i].current < health[i].max ? health[i].current : health[i].max;
+        }
+    }
+
+#if defined(HYP_SIMD_X86)
+
+    // 🚀 SSE2, every x86-64 CPU has it
+
+    inline void scaled_add_sse2(float* out, const float* in, std::size_t count, float scale) {
+        const __m128 factor = _mm_set1_ps(scale);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 sum = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), factor));
+            _mm_storeu_ps(out + i, sum);
+        }
+        scaled_add_scalar(out + i, in + i, count - i, scale);
+    }
+
+    /**
+     * One Health is [max, current], pairs are swapped to line each current up with its max.
+     * SSE2 has no 32 bit min, so it is a compare and select.
+     */
+    inline void clamp_health_sse2(Health* health, std::size_t count) {
+        static_assert(sizeof(Health) == 2 * sizeof(std::int32_t));
+        auto* data = reinterpret_cast<__m128i*>(health);
+        const __m128i current_lanes = _mm_set_epi32(-1, 0, -1, 0);
+        std::size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            const __m128i pairs = _mm_loadu_si128(data + i / 2);
+            const __m128i swapped = _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1));
+            const __m128i greater = _mm_cmpgt_epi32(pairs, swapped);
+            const __m128i minimum = _mm_or_si128(_mm_and_si128(greater, swapped), _mm_andnot_si128(greater, pairs));
+            const __m128i clamped = _mm_or_si128(_mm_and_si128(current_lanes, minimum), _mm_andnot_si128(current_lanes, pairs));
+            _mm_storeu_si128(data + i / 2, clamped);
+        }
+        clamp_health_scalar(health + i, count - i);
+    }
+
+    // 🚀🚀 AVX2
+
+    HYP_TARGET_AVX2
+    inline void scaled_add_avx2(float* out, const float* in, std::size_t count, float scale) {
+        const __m256 factor = _mm256_set1_ps(scale);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 sum = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(in + i), factor));
+            _mm256_storeu_ps(out + i, sum);
+        }
+        scaled_add_scalar(out + i, in + i, count - i, scale);
+    }
+
+    HYP_TARGET_AVX2
+    inline void integrate_avx2(Physics* physics, std::size_t count, float dt) {
+        float* data = reinterpret_cast<float*>(physics);
+        const __m256 factor = _mm256_set1_ps(dt);
+        const __m256 zero = _mm256_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            const __m256 bodies = _mm256_loadu_ps(data + i * 4);
+            const __m256 steps = _mm256_shuffle_ps(bodies, zero, _MM_SHUFFLE(0, 0, 3, 2));
+            _mm256_storeu_ps(data + i * 4, _mm256_add_ps(bodies, _mm256_mul_ps(steps, factor)));
+        }
+        integrate_scalar(physics + i, count - i, dt);
+    }
+
+    HYP_TARGET_AVX2
+    inline void clamp_health_avx2(Health* health, std::size_t count) {
+        auto* data = reinterpret_cast<__m256i*>(health);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256i pairs = _mm256_loadu_si256(data + i / 4);
+            const __m256i swapped = _mm256_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1));
+            const __m256i clamped = _mm256_blend_epi32(pairs, _mm256_min_epi32(pairs, swapped), 0b10101010);
+            _mm256_storeu_si256(data + i / 4, clamped);
+        }
+        clamp_health_scalar(health + i, count - i);
+    }
+
+#endif
+
+    // 🎛 Dispatch on the detected level, or a forced one for benchmarking
+
+    inline void scaled_add(std::span<float> out, std::span<const float> in, float scale, Level level = detect()) {
+        switch (level) {
+#if defined(HYP_SIMD_X86)
+            case Level::avx2: return scaled_add_avx2(out.data(), in.data(), out.size(), scale);
+            case Level::sse2: return scaled_add_sse2(out.data(), in.data(), out.size(), scale);
+#endif
+            default: return scaled_add_scalar(out.data(), in.data(), out.size(), scale);
+        }
+    }
+
+    /**
+     * 🏃 position += velocity * dt over separate x/y arrays
+     */
+    inline void integrate(std::span<float> position_x, std::span<float> position_y,
+                          std::span<const float> velocity_x, std::span<const float> velocity_y,
+                          float dt, Level level = detect()) {
+        scaled_add(position_x, velocity_x, dt, level);
+        scaled_add(position_y, velocity_y, dt, level);
+    }
+
+    /**
+     * 🏃 position += velocity * dt straight over a Physics column.
+     * The compiler already turns the scalar loop into SSE2, a hand-written SSE2 kernel never beat it.
+     */
+    inline void integrate(std::span<Physics> physics, float dt, Level level = detect()) {
+        switch (level) {
+#if defined(HYP_SIMD_X86)
+            case Level::avx2: return integrate_avx2(physics.data(), physics.size(), dt);
+#endif
+            default: return integrate_scalar(physics.data(), physics.size(), dt);
+        }
+    }
+
+    /**
+     * 🩹 current = min(current, max) over a Health column
+     */
+    inline void clamp_health(std::span<Health> health, Level level = detect()) {
+        switch (level) {
+#if defined(HYP_SIMD_X86)
+            case Level::avx2: return clamp_health_avx2(health.data(), health.size());
+            case Level::sse2: return clamp_health_sse2(health.data(), health.size());
+#endif
+            default: return clamp_health_scalar(health.data(), health.size());
+        }
+    }
+}
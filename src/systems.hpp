@@ -0,0 +1,44 @@
+#pragma once
+
+#include "archetype.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+
+namespace hyp {
+
+    /**
+     * 🏃 position += velocity * dt for every entity with Physics
+     */
+    template<typename StoreType>
+    void integrate_physics(StoreType& store, float dt) {
+        store.template view<Physics>().each_chunk([dt](std::span<Physics> physics) {
+            simd::integrate(physics, dt);
+        });
+    }
+
+    template<typename StoreType>
+    void integrate_physics(StoreType& store, ThreadPool& pool, float dt) {
+        store.template view<Physics>().par_each_chunk(pool, [dt](std::span<Physics> physics) {
+            simd::integrate(physics, dt);
+        });
+    }
+
+    /**
+     * 🩹 Clamp current health to max, then swap-and-pop everything at zero or below.
+     * Returns how many entities died.
+     */
+    template<typename StoreType>
+    std::size_t update_health(StoreType& store) {
+        auto health = store.template view<Health>();
+        health.each_chunk([](std::span<Health> column) {
+            simd::clamp_health(column);
+        });
+        std::size_t dead = 0;
+        health.each_archetype([&dead](auto& archetype) {
+            dead += archetype.template remove_if<Health>([](const Health& health) {
+                return health.current <= 0;
+            });
+        });
+        return dead;
+    }
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hyp {
+
+    // Threads that can hold a thread_index() at the same time
+    inline constexpr std::size_t max_thread_indices = 64;
+
+    namespace detail {
+
+        inline std::atomic<std::uint64_t> taken_thread_indices{0};
+
+        /**
+         * The calling thread's index, given back when the thread exits
+         */
+        struct ThreadIndexSlot {
+            const std::size_t index = take();
+
+            ~ThreadIndexSlot() {
+                taken_thread_indices.fetch_and(~(std::uint64_t{1} << index), std::memory_order_release);
+            }
+
+            static std::size_t take() {
+                static_assert(max_thread_indices == 64, "one bit per index in taken_thread_indices");
+                std::uint64_t taken = taken_thread_indices.load(std::memory_order_relaxed);
+                while (true) {
+                    if (taken == ~std::uint64_t{0}) {
+                        std::cerr << "thread_index: more than " << max_thread_indices
+                                  << " threads need an index at once" << std::endl;
+                        std::abort();
+                    }
+                    const auto index = std::size_t(std::countr_one(taken));
+                    if (taken_thread_indices.compare_exchange_weak(taken, taken | (std::uint64_t{1} << index),
+                                                                   std::memory_order_acquire, std::memory_order_relaxed)) {
+                        return index;
+                    }
+                }
+            }
+        };
+    }
+
+    /**
+     * 🔢 Small dense number for the calling thread, below max_thread_indices, handed out on first use.
+     * Good for indexing per-thread slots without any locking. A thread's index goes back to the pool
+     * when it exits, so threads coming and going can't run past the end; more than max_thread_indices
+     * threads holding one at once aborts.
+     */
+    inline std::size_t thread_index() {
+        thread_local const detail::ThreadIndexSlot slot;
+        return slot.index;
+    }
+
+    /**
+     * 🧵 Fixed set of worker threads with a task deque each.
+     * A worker pushes and pops its own deque at the back, so it keeps working on what it just
+     * spawned while that's still in cache, and steals from the front of the others once it runs dry.
+     * Threads outside the pool submit into one extra shared deque.
+     * parallel_for is the main entry point. The calling thread works on chunks too, and while it
+     * waits it runs other pending tasks, so nested parallel_for calls from inside tasks can't starve the pool.
+     */
+    class ThreadPool {
+    public:
+        // Default size, leaves thread indices for the threads driving the pool
+        static std::size_t default_thread_count() {
+            return std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()) - 1, max_thread_indices / 2);
+        }
+
+        explicit ThreadPool(std::size_t thread_count = default_thread_count()) {
+            queues.reserve(thread_count + 1);
+            for (std::size_t i = 0; i < thread_count + 1; ++i) {
+                queues.push_back(std::make_unique<Queue>());
+            }
+            workers.reserve(thread_count);
+            for (std::size_t i = 0; i < thread_count; ++i) {
+                workers.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock{sleep_mutex};
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        /**
+         * 🌍 Pool shared by everything that doesn't bring its own
+         */
+        static ThreadPool& shared() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        std::size_t size() const {
+            return workers.size();
+        }
+
+        void submit(std::function<void()> task) {
+            Queue& queue = *queues[home()];
+            {
+                std::lock_guard lock{queue.mutex};
+                queue.push_back(std::move(task));
+            }
+            pending.fetch_add(1, std::memory_order_release);
+            // Taking the lock orders this with a worker that is about to sleep, so the wakeup can't be lost
+            { std::lock_guard lock{sleep_mutex}; }
+            wake.notify_one();
+        }
+
+        /**
+         * 🤝 Run pending tasks on the calling thread until done() holds.
+         * With nothing left to run it yields for a few rounds, then sleeps until a task finishes
+         * or a new one comes in, so a long wait doesn't burn a core.
+         */
+        template<typename Done>
+        void help_until(Done&& done) {
+            std::size_t idle = 0;
+            while (!done()) {
+                if (run_one(home())) {
+                    idle = 0;
+                    continue;
+                }
+                if (++idle < idle_yields) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::unique_lock lock{sleep_mutex};
+                waiting_helpers.fetch_add(1, std::memory_order_seq_cst);
+                // Pairs with the fence in run_one, either we see the task's result or it sees us waiting
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                wake.wait(lock, [&] { return done() || pending.load(std::memory_order_acquire) > 0; });
+                waiting_helpers.fetch_sub(1, std::memory_order_relaxed);
+                idle = 0;
+            }
+        }
+
+        /**
+         * ✂ Split [0, count) into chunks of `grain` and run body(begin, end) on each,
+         * returns once every chunk has finished
+         */
+        template<typename Body>
+        void parallel_for(std::size_t count, std::size_t grain, Body&& body) {
+            if (count == 0) {
+                return;
+            }
+            grain = std::max<std::size_t>(grain, 1);
+            const std::size_t chunks = (count + grain - 1) / grain;
+            const std::size_t helpers = std::min(chunks - 1, workers.size());
+
+            std::atomic<std::size_t> next_chunk{0};
+            std::atomic<std::size_t> finished_helpers{0};
+
+            const auto drain = [&] {
+                for (std::size_t chunk = next_chunk++; chunk < chunks; chunk = next_chunk++) {
+                    const std::size_t begin = chunk * grain;
+                    body(begin, std::min(begin + grain, count));
+                }
+            };
+
+            for (std::size_t i = 0; i < helpers; ++i) {
+                submit([&] {
+                    drain();
+                    finished_helpers.fetch_add(1, std::memory_order_release);
+                });
+            }
+            drain();
+
+            help_until([&] { return finished_helpers.load(std::memory_order_acquire) == helpers; });
+        }
+
+    private:
+        /**
+         * Ring of tasks that only ever grows, so a busy pool stops allocating once it's warm
+         */
+        struct Queue {
+            std::mutex mutex;
+            std::vector<std::function<void()>> slots;
+            std::size_t head = 0;
+            std::size_t count = 0;
+
+            void push_back(std::function<void()> task) {
+                if (count == slots.size()) {
+                    std::vector<std::function<void()>> grown(std::max<std::size_t>(slots.size() * 2, 16));
+                    for (std::size_t i = 0; i < count; ++i) {
+                        grown[i] = std::move(slots[(head + i) % slots.size()]);
+                    }
+                    slots = std::move(grown);
+                    head = 0;
+                }
+                slots[(head + count++) % slots.size()] = std::move(task);
+            }
+
+            std::function<void()> pop_back() {
+                return std::move(slots[(head + --count) % slots.size()]);
+            }
+
+            std::function<void()> pop_front() {
+                auto task = std::move(slots[head]);
+                head = (head + 1) % slots.size();
+                --count;
+                return task;
+            }
+        };
+
+        // Yields help_until makes before it goes to sleep
+        static constexpr std::size_t idle_yields = 16;
+
+        // Which pool the current thread works for and its deque there
+        static inline thread_local const ThreadPool* worker_pool = nullptr;
+        static inline thread_local std::size_t worker_queue = 0;
+
+        std::vector<std::thread> workers;
+        // One per worker, the last one takes submissions from outside the pool
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::atomic<std::size_t> pending{0};
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        // Threads asleep in help_until, they need waking whenever a task finishes
+        std::atomic<std::size_t> waiting_helpers{0};
+        bool stopping = false;
+
+        std::size_t home() const {
+            return worker_pool == this ? worker_queue : queues.size() - 1;
+        }
+
+        /**
+         * Newest task from our own deque, otherwise the oldest one from someone else's
+         */
+        bool run_one(std::size_t own) {
+            std::function<void()> task;
+            for (std::size_t i = 0; i < queues.size() && !task; ++i) {
+                Queue& queue = *queues[(own + i) % queues.size()];
+                std::lock_guard lock{queue.mutex};
+                if (queue.count == 0) {
+                    continue;
+                }
+                task = i == 0 ? queue.pop_back() : queue.pop_front();
+            }
+            if (!task) {
+                return false;
+            }
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_helpers.load(std::memory_order_relaxed) > 0) {
+                { std::lock_guard lock{sleep_mutex}; }
+                wake.notify_all();
+            }
+            return true;
+        }
+
+        void work(std::size_t index) {
+            worker_pool = this;
+            worker_queue = index;
+            while (true) {
+                if (run_one(index)) {
+                    continue;
+                }
+                std::unique_lock lock{sleep_mutex};
+                wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+                if (stopping && pending.load(std::memory_order_acquire) == 0) {
+                    return;
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace hyp {
+
+    /**
+     * 🔺 Hands the newest value from one producer thread to one consumer thread without locks or waiting.
+     * The producer fills back() and publish()es it. The consumer calls update() and reads front().
+     * The third slot sits in the middle, so neither side ever touches the slot the other is using.
+     * Values the consumer didn't get to are dropped, it only ever sees the latest.
+     */
+    template<typename T>
+    class TripleBuffer {
+    public:
+        /**
+         * Prepare all three slots, e.g. reserve capacity. Only before the threads start sharing the buffer.
+         */
+        template<typename Visit>
+        void for_each_slot(Visit&& visit) {
+            for (auto& slot : slots) {
+                visit(slot);
+            }
+        }
+
+        T& back() {
+            return slots[back_index];
+        }
+
+        /**
+         * 📤 Make back() the latest value, and take over the old middle slot as the new back()
+         */
+        void publish() {
+            back_index = middle.exchange(std::uint8_t(back_index | fresh), std::memory_order_acq_rel) & index_mask;
+        }
+
+        /**
+         * 📥 Swap in the latest published value if there is one, returns whether front() changed
+         */
+        bool update() {
+            if (!(middle.load(std::memory_order_relaxed) & fresh)) {
+                return false;
+            }
+            front_index = middle.exchange(front_index, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
+
+        const T& front() const {
+            return slots[front_index];
+        }
+
+    private:
+        static constexpr std::uint8_t index_mask = 0b011;
+        // Set while the middle slot holds something the consumer hasn't picked up
+        static constexpr std::uint8_t fresh = 0b100;
+
+        std::array<T, 3> slots{};
+        std::uint8_t back_index = 0;
+        std::atomic<std::uint8_t> middle{1};
+        std::uint8_t front_index = 2;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+namespace hyp {
+
+    /**
+     * 🧵 String that lives entirely in a constant expression, text() is null terminated
+     */
+    template<std::size_t N>
+    struct FixedString {
+        char characters[N + 1]{};
+
+        constexpr FixedString() = default;
+
+        constexpr explicit FixedString(std::string_view text) {
+            std::copy_n(text.data(), std::min(N, text.size()), characters);
+        }
+
+        constexpr const char* text() const {
+            return characters;
+        }
+
+        constexpr std::string_view view() const {
+            return {characters, N};
+        }
+
+        static constexpr std::size_t size() {
+            return N;
+        }
+    };
+
+    namespace detail {
+        template<class T>
+        constexpr std::string_view signature() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
+#endif
+        }
+
+        /**
+         * Cut T out of signature<T>(), the compilers only differ in what surrounds it:
+         *   GCC   "... signature() [with T = ns::Name; ...]"
+         *   Clang "... signature() [T = ns::Name]"
+         *   MSVC  "... signature<class ns::Name>(void)"
+         */
+        template<class T>
+        constexpr std::string_view qualified_name() {
+            std::string_view name = signature<T>();
+#if defined(_MSC_VER) && !defined(__clang__)
+            name.remove_prefix(name.find("signature<") + 10);
+            name.remove_suffix(name.size() - name.rfind(">(void)"));
+            for (const std::string_view keyword : {"class ", "struct ", "enum "}) {
+                if (name.starts_with(keyword)) {
+                    name.remove_prefix(keyword.size());
+                }
+            }
+#else
+            name.remove_prefix(name.find("T = ") + 4);
+            name = name.substr(0, std::min(name.find(';'), name.rfind(']')));
+#endif
+            return name;
+        }
+    }
+
+    /**
+     * 🏷 Unqualified name of T, worked out by the compiler - same result on GCC, Clang and MSVC,
+     * no RTTI. Namespaces and enclosing functions are dropped, so a class declared inside
+     * run_scene() is just its own name.
+     */
+    template<class T>
+    constexpr std::string_view type_name() {
+        constexpr std::string_view name = detail::qualified_name<T>();
+        constexpr std::size_t scope = name.rfind("::");
+        return scope == std::string_view::npos ? name : name.substr(scope + 2);
+    }
+
+    /**
+     * type_name<T>() as a null terminated constant, for APIs that want a C string
+     */
+    template<class T>
+    inline constexpr auto type_name_v = FixedString<type_name<T>().size()>{type_name<T>()};
+}
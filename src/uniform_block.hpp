@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include "buffer_pool.hpp"
+#include "gl_state.hpp"
+
+namespace hyp::gl {
+
+    /**
+     * GLSL spelling plus std140 base alignment and size of one block member
+     */
+    struct Std140Type {
+        const char* glsl;
+        std::size_t alignment;
+        std::size_t size;
+    };
+
+    template<typename T>
+    constexpr Std140Type std140_type() {
+        if constexpr (std::is_same_v<T, float>) {
+            return {"float", 4, 4};
+        } else if constexpr (std::is_same_v<T, std::int32_t>) {
+            return {"int", 4, 4};
+        } else if constexpr (std::is_same_v<T, glm::vec2>) {
+            return {"vec2", 8, 8};
+        } else if constexpr (std::is_same_v<T, glm::vec3>) {
+            return {"vec3", 16, 12};
+        } else if constexpr (std::is_same_v<T, glm::vec4>) {
+            return {"vec4", 16, 16};
+        } else if constexpr (std::is_same_v<T, glm::mat4>) {
+            return {"mat4", 16, 64};
+        } else {
+            static_assert(sizeof(T) == 0, "no std140 mapping for this type");
+        }
+    }
+
+    struct BlockField {
+        const char* name;
+        Std140Type type;
+        std::size_t offset;
+    };
+
+    /**
+     * 📐 Specialize with a `fields` array of HYPER_BLOCK_FIELD entries, in declaration order
+     */
+    template<typename Block>
+    struct BlockSchema;
+
+    #define HYPER_BLOCK_FIELD(block, member) \
+        hyp::gl::BlockField{ #member, hyp::gl::std140_type<decltype(block::member)>(), offsetof(block, member) }
+
+    /**
+     * ✅ The C++ struct lays out exactly like the std140 block GLSL will read
+     */
+    template<typename Block>
+    constexpr bool std140_matches() {
+        const auto align = [](std::size_t value, std::size_t to) {
+            return (value + to - 1) / to * to;
+        };
+        std::size_t offset = 0;
+        for (const auto& field : BlockSchema<Block>::fields) {
+            offset = align(offset, field.type.alignment);
+            if (field.offset != offset) {
+                return false;
+            }
+            offset += field.type.size;
+        }
+        return align(offset, 16) == sizeof(Block);
+    }
+
+    /**
+     * 💍 Uniform buffer holding one Block per frame in flight.
+     * Every upload() writes the next slot unsynchronized and points the binding at it. Each slot is
+     * fenced once the frame that read it is submitted, and upload() waits on that fence before
+     * overwriting the slot, so the CPU only ever blocks when more than `frames - 1` frames are queued.
+     * Programs pick the data up through their block binding, nothing is uploaded per program.
+     */
+    template<typename Block>
+    class UniformRing {
+    public:
+        static_assert(std140_matches<Block>(), "Block doesn't follow std140 layout, check member order and padding");
+
+        static constexpr std::size_t frames = 3;
+
+        explicit UniformRing(GLuint binding) :
+            binding{binding} {
+            GLint alignment = 0;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            alignment = std::max(alignment, 1);
+            stride = (sizeof(Block) + alignment - 1) / alignment * alignment;
+
+            glGenBuffers(1, &buffer);
+            state.bind_buffer(GL_UNIFORM_BUFFER, buffer);
+            glBufferData(GL_UNIFORM_BUFFER, GLsizeiptr(stride * frames), nullptr, GL_DYNAMIC_DRAW);
+            ++buffer_stats.buffers_live;
+        }
+
+        UniformRing(const UniformRing&) = delete;
+        UniformRing& operator=(const UniformRing&) = delete;
+
+        ~UniformRing() {
+            for (GLsync fence : fences) {
+                if (fence) {
+                    glDeleteSync(fence);
+                }
+            }
+            state.forget_buffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            --buffer_stats.buffers_live;
+        }
+
+        /**
+         * ⬆ Publish `block` for this frame to every program using the binding
+         */
+        void upload(const Block& block) {
+            // Everything reading the current slot has been submitted by now
+            fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            slot = (slot + 1) % frames;
+            wait_for_slot();
+            const auto offset = GLintptr(slot * stride);
+            state.bind_buffer(GL_UNIFORM_BUFFER, buffer);
+            void* target = glMapBufferRange(GL_UNIFORM_BUFFER, offset, sizeof(Block),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (target) {
+                std::memcpy(target, &block, sizeof(Block));
+                glUnmapBuffer(GL_UNIFORM_BUFFER);
+            } else {
+                glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(Block), &block);
+            }
+            state.bind_buffer_range(GL_UNIFORM_BUFFER, binding, buffer, offset, sizeof(Block));
+
+            for (auto* counters : {&buffer_stats.frame, &buffer_stats.total}) {
+                counters->bytes_uploaded += sizeof(Block);
+                ++counters->uploads;
+            }
+        }
+
+    private:
+        GLuint buffer = 0;
+        const GLuint binding;
+        std::size_t stride = 0;
+        std::size_t slot = frames - 1;
+        // Signalled once the GPU is done with the frame that read the slot
+        std::array<GLsync, frames> fences{};
+
+        void wait_for_slot() {
+            const GLsync fence = std::exchange(fences[slot], nullptr);
+            if (!fence) {
+                return;
+            }
+            GLenum status;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+            } while (status == GL_TIMEOUT_EXPIRED);
+            if (status == GL_WAIT_FAILED) {
+                std::cerr << "UniformRing: waiting for the GPU to release a slot failed" << std::endl;
+            }
+            glDeleteSync(fence);
+        }
+    };
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "gl_state.hpp"
+#include "hash.hpp"
+
+namespace hyp::gl {
+
+    /**
+     * 🔌 Where one attribute reads from. `serial` identifies the buffer object for good,
+     * GL recycles buffer names after deletion so `buffer` alone can't key a cache.
+     */
+    struct AttributeSource {
+        GLuint buffer = 0;
+        std::uint64_t serial = 0;
+        GLint location = -1;
+        GLint size = 0;
+        GLsizei stride = 0;
+        std::uintptr_t offset = 0;
+        GLuint divisor = 0;
+
+        bool operator==(const AttributeSource&) const = default;
+
+        bool active() const {
+            return location >= 0 && buffer;
+        }
+    };
+
+    struct VertexArrayStats {
+        std::size_t built = 0;
+        std::size_t reused = 0;
+        std::size_t evicted = 0;
+    };
+
+    /**
+     * 🗃 One vertex array object per distinct set of attribute sources.
+     * The first get() for a set records the whole attribute setup into a new VAO,
+     * after that the same set costs a hash, a compare and a single glBindVertexArray.
+     * Deleting a buffer evicts every VAO reading from it, see forget_buffer().
+     * GL thread only.
+     */
+    class VertexArrayCache {
+    public:
+        VertexArrayCache() {
+            live.push_back(this);
+        }
+
+        VertexArrayCache(const VertexArrayCache&) = delete;
+        VertexArrayCache& operator=(const VertexArrayCache&) = delete;
+
+        VertexArrayCache(VertexArrayCache&& other) noexcept :
+            arrays{std::move(other.arrays)},
+            array_count{std::exchange(other.array_count, 0)},
+            counters{other.counters} {
+            other.arrays.clear();
+            live.push_back(this);
+        }
+
+        VertexArrayCache& operator=(VertexArrayCache&& other) noexcept {
+            std::swap(arrays, other.arrays);
+            std::swap(array_count, other.array_count);
+            std::swap(counters, other.counters);
+            return *this;
+        }
+
+        ~VertexArrayCache() {
+            clear();
+            live.erase(std::find(live.begin(), live.end(), this));
+        }
+
+        /**
+         * 🧹 Delete every cached VAO, in every cache, that reads from the buffer with `serial`.
+         * Buffers call this as they are deleted, so no VAO keeps pointing at a dead buffer name.
+         */
+        static void forget_buffer(std::uint64_t serial) {
+            for (auto* cache : live) {
+                cache->evict(serial);
+            }
+        }
+
+        /**
+         * 🔑 VAO reading from `sources`, built on first use. Sources with location -1 are skipped.
+         */
+        GLuint get(std::span<const AttributeSource> sources) {
+            std::uint64_t key = hash_bytes({});
+            for (const auto& source : sources) {
+                if (!source.active()) {
+                    continue;
+                }
+                const std::uint64_t fields[] = {
+                    source.serial, std::uint64_t(source.location), std::uint64_t(source.size),
+                    std::uint64_t(source.stride), source.offset, source.divisor,
+                };
+                key = hash_bytes(std::as_bytes(std::span{fields}), key);
+            }
+
+            auto& bucket = arrays[key];
+            for (const auto& entry : bucket) {
+                if (same_layout(entry.layout, sources)) {
+                    ++counters.reused;
+                    return entry.array;
+                }
+            }
+
+            Entry entry;
+            glGenVertexArrays(1, &entry.array);
+            state.bind_vertex_array(entry.array);
+            for (const auto& source : sources) {
+                if (!source.active()) {
+                    continue;
+                }
+                state.bind_buffer(GL_ARRAY_BUFFER, source.buffer);
+                state.enable_attribute(source.location);
+                state.attribute_pointer(source.location, source.size, GL_FLOAT, GL_FALSE, source.stride, source.offset);
+                state.attribute_divisor(source.location, source.divisor);
+                entry.layout.push_back(source);
+            }
+            bucket.push_back(std::move(entry));
+            ++array_count;
+            ++counters.built;
+            return bucket.back().array;
+        }
+
+        void clear() {
+            for (const auto& [key, bucket] : arrays) {
+                for (const auto& entry : bucket) {
+                    destroy(entry.array);
+                }
+            }
+            arrays.clear();
+            array_count = 0;
+        }
+
+        std::size_t size() const {
+            return array_count;
+        }
+
+        const VertexArrayStats& stats() const {
+            return counters;
+        }
+
+    private:
+        friend void test_vertex_array_cache();
+
+        struct Entry {
+            // The active sources the VAO was built from, compared on every hit so a hash collision can't alias
+            std::vector<AttributeSource> layout;
+            GLuint array = 0;
+        };
+
+        static inline std::vector<VertexArrayCache*> live;
+
+        std::unordered_map<std::uint64_t, std::vector<Entry>> arrays;
+        std::size_t array_count = 0;
+        VertexArrayStats counters;
+
+        static bool same_layout(std::span<const AttributeSource> layout, std::span<const AttributeSource> sources) {
+            std::size_t matched = 0;
+            for (const auto& source : sources) {
+                if (!source.active()) {
+                    continue;
+                }
+                if (matched == layout.size() || !(layout[matched] == source)) {
+                    return false;
+                }
+                ++matched;
+            }
+            return matched == layout.size();
+        }
+
+        static void destroy(GLuint array) {
+            state.forget_vertex_array(array);
+            glDeleteVertexArrays(1, &array);
+        }
+
+        void evict(std::uint64_t serial) {
+            for (auto bucket = arrays.begin(); bucket != arrays.end();) {
+                auto& entries = bucket->second;
+                // Partition rather than remove_if, the tail has to hold the stale entries themselves, not moved-from copies
+                const auto stale = std::stable_partition(entries.begin(), entries.end(), [serial](const Entry& entry) {
+                    return std::none_of(entry.layout.begin(), entry.layout.end(), [serial](const AttributeSource& source) {
+                        return source.serial == serial;
+                    });
+                });
+                for (auto entry = stale; entry != entries.end(); ++entry) {
+                    destroy(entry->array);
+                    --array_count;
+                    ++counters.evicted;
+                }
+                entries.erase(stale, entries.end());
+                bucket = entries.empty() ? arrays.erase(bucket) : std::next(bucket);
+            }
+        }
+    };
+
+
+    // 👨‍🔬
+    void test_vertex_array_cache() {
+        // No context needed, deletions land here instead of the driver
+        static std::vector<GLuint> deleted;
+        struct Deletions {
+            static void APIENTRY record(GLsizei count, const GLuint* names) {
+                deleted.insert(deleted.end(), names, names + count);
+            }
+        };
+        const auto original = glad_glDeleteVertexArrays;
+        glad_glDeleteVertexArrays = &Deletions::record;
+        {
+            // Two layouts colliding into one bucket, the first reads from the buffer that goes away
+            VertexArrayCache cache;
+            const auto stale = AttributeSource{1, 7, 0, 2, 0, 0, 0};
+            const auto kept = AttributeSource{2, 8, 0, 2, 0, 0, 0};
+            auto& bucket = cache.arrays[0];
+            bucket.push_back({{stale}, 10});
+            bucket.push_back({{kept}, 20});
+            cache.array_count = 2;
+
+            VertexArrayCache::forget_buffer(stale.serial);
+            assert(deleted == std::vector<GLuint>{10});
+            assert(cache.size() == 1 && cache.arrays.at(0).front().array == 20);
+        }
+        assert((deleted == std::vector<GLuint>{10, 20}));
+        glad_glDeleteVertexArrays = original;
+    }
+}
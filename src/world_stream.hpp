@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "hyper_file.hpp"
+
+/**
+ * 🧩 Chunked .hyper worlds
+ *
+ * Same file layout as any other .hyper file, with three tables:
+ *     chunk_grid - one ChunkGrid, the side length of a chunk in world units
+ *     chunks     - one ChunkDescriptor per non-empty cell, with the cell's [first, first + count) record range
+ *     records    - every record, sorted so each cell's records are contiguous
+ * ChunkStream only ever reads the descriptors up front, records are paged in per chunk.
+ */
+namespace hyp::hyper {
+
+    struct ChunkGrid {
+        float chunk_size;
+    };
+
+    struct ChunkDescriptor {
+        std::int32_t cell_x;
+        std::int32_t cell_y;
+        std::uint64_t first;
+        std::uint64_t count;
+        std::uint64_t hash;
+    };
+
+    template<>
+    struct Schema<ChunkGrid> {
+        static constexpr const char* type_name = "hyp::hyper::ChunkGrid";
+        static constexpr std::array fields {
+            HYPER_FIELD(ChunkGrid, chunk_size),
+        };
+    };
+
+    template<>
+    struct Schema<ChunkDescriptor> {
+        static constexpr const char* type_name = "hyp::hyper::ChunkDescriptor";
+        static constexpr std::array fields {
+            HYPER_FIELD(ChunkDescriptor, cell_x),
+            HYPER_FIELD(ChunkDescriptor, cell_y),
+            HYPER_FIELD(ChunkDescriptor, first),
+            HYPER_FIELD(ChunkDescriptor, count),
+            HYPER_FIELD(ChunkDescriptor, hash),
+        };
+    };
+
+    struct Cell {
+        std::int32_t x;
+        std::int32_t y;
+
+        bool operator==(const Cell&) const = default;
+    };
+
+    struct CellHash {
+        std::size_t operator()(Cell cell) const {
+            const auto key = (std::uint64_t(std::uint32_t(cell.x)) << 32) | std::uint32_t(cell.y);
+            return std::size_t(key * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    /**
+     * 📍 Cell of any record with x and y members
+     */
+    template<typename Record>
+    Cell cell_of(const Record& record, float chunk_size) {
+        return {
+            static_cast<std::int32_t>(std::floor(record.x / chunk_size)),
+            static_cast<std::int32_t>(std::floor(record.y / chunk_size)),
+        };
+    }
+
+    /**
+     * ✍ Bucket records into cells of `chunk_size` and write the chunked layout
+     */
+    template<typename Record>
+    bool write_chunked(const std::string& path, std::span<const Record> records, float chunk_size) {
+        std::vector<Record> sorted(records.begin(), records.end());
+        std::stable_sort(sorted.begin(), sorted.end(), [chunk_size](const Record& a, const Record& b) {
+            const Cell left = cell_of(a, chunk_size);
+            const Cell right = cell_of(b, chunk_size);
+            return left.y != right.y ? left.y < right.y : left.x < right.x;
+        });
+
+        std::vector<ChunkDescriptor> chunks;
+        for (std::size_t first = 0; first < sorted.size();) {
+            const Cell cell = cell_of(sorted[first], chunk_size);
+            std::size_t last = first + 1;
+            while (last < sorted.size() && cell_of(sorted[last], chunk_size) == cell) {
+                ++last;
+            }
+            const auto run = std::span<const Record>{sorted}.subspan(first, last - first);
+            chunks.push_back({cell.x, cell.y, first, run.size(), hash_bytes(std::as_bytes(run))});
+            first = last;
+        }
+
+        const ChunkGrid grid{chunk_size};
+        return Writer{}
+                .table("chunk_grid", std::span<const ChunkGrid>{&grid, 1})
+                .table("chunks", chunks)
+                .table("records", sorted)
+                .write(path);
+    }
+
+    /**
+     * 📦 Keeps the chunks around a focus point resident under a memory budget.
+     * A loader thread reads chunks nearest-first and pages out the ones the focus has left behind,
+     * evicting the farthest early if the budget runs out. The game thread only looks at what is resident.
+     * A chunk whose records don't match the hash in its descriptor is never made resident.
+     */
+    template<typename Record>
+    class ChunkStream {
+    public:
+        struct Chunk {
+            Cell cell;
+            std::uint64_t hash;
+            std::vector<Record> records;
+        };
+
+        struct Settings {
+            float load_radius = 256.0f;
+            std::size_t memory_budget = std::size_t{256} << 20;
+            // Chunks stay until they are this much farther out than load_radius, so a focus
+            // wobbling across a chunk border doesn't page the same chunks in and out
+            float unload_margin = 64.0f;
+        };
+
+        struct Stats {
+            std::uint64_t hits;
+            std::uint64_t misses;
+            std::uint64_t loads;
+            std::uint64_t evictions;
+            std::uint64_t rejected;
+            std::size_t resident_chunks;
+            std::size_t resident_bytes;
+            double load_ms_average;
+            double load_ms_max;
+        };
+
+        ChunkStream(const std::string& path, Settings settings) :
+            settings{settings},
+            file{path, std::ios::binary} {
+            if (!read_directory()) {
+                std::cerr << "hyper: '" << path << "' is not a chunked .hyper file" << std::endl;
+                directory.clear();
+                return;
+            }
+            loader = std::thread{[this] { load_loop(); }};
+        }
+
+        ChunkStream(const ChunkStream&) = delete;
+        ChunkStream& operator=(const ChunkStream&) = delete;
+
+        ~ChunkStream() {
+            {
+                std::lock_guard lock{mutex};
+                stopping = true;
+            }
+            wake.notify_one();
+            if (loader.joinable()) {
+                loader.join();
+            }
+        }
+
+        explicit operator bool() const {
+            return !directory.empty();
+        }
+
+        float chunk_size() const {
+            return grid.chunk_size;
+        }
+
+        /**
+         * 🎯 Move the point chunks are streamed around
+         */
+        void focus(float x, float y) {
+            {
+                std::lock_guard lock{mutex};
+                focus_x = x;
+                focus_y = y;
+                focus_changed = true;
+            }
+            wake.notify_one();
+        }
+
+        /**
+         * 🔍 Resident chunk at `cell`, or null with a load queued if it isn't in yet.
+         * Cells with no records, or with records that failed their hash, are neither hits nor misses.
+         */
+        std::shared_ptr<const Chunk> chunk(Cell cell) {
+            if (!directory.contains(cell)) {
+                return nullptr;
+            }
+            std::unique_lock lock{mutex};
+            if (const auto found = resident.find(cell); found != resident.end()) {
+                ++hits;
+                return found->second;
+            }
+            if (corrupt.contains(cell)) {
+                return nullptr;
+            }
+            ++misses;
+            requests.push_back(cell);
+            lock.unlock();
+            wake.notify_one();
+            return nullptr;
+        }
+
+        /**
+         * 🔁 body(const Chunk&) for every resident chunk, the loader waits meanwhile
+         */
+        template<typename Body>
+        void each_resident(Body&& body) {
+            std::lock_guard lock{mutex};
+            for (const auto& [cell, chunk] : resident) {
+                body(*chunk);
+            }
+        }
+
+        Stats stats() {
+            std::lock_guard lock{mutex};
+            return {
+                hits,
+                misses,
+                loads,
+                evictions,
+                rejected,
+                resident.size(),
+                resident_bytes,
+                loads ? load_ms_total / double(loads) : 0.0,
+                load_ms_max,
+            };
+        }
+
+    private:
+        const Settings settings;
+        std::ifstream file;
+        ChunkGrid grid{1.0f};
+        std::uint64_t records_offset = 0;
+        std::unordered_map<Cell, ChunkDescriptor, CellHash> directory;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread loader;
+        bool stopping = false;
+        bool focus_changed = false;
+        float focus_x = 0;
+        float focus_y = 0;
+        std::vector<Cell> requests;
+        std::unordered_map<Cell, std::shared_ptr<const Chunk>, CellHash> resident;
+        // Failed their hash once, so they aren't read again every time the focus moves
+        std::unordered_set<Cell, CellHash> corrupt;
+        std::size_t resident_bytes = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t loads = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t rejected = 0;
+        double load_ms_total = 0;
+        double load_ms_max = 0;
+
+        bool read_directory() {
+            FileHeader header{};
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                header.magic != magic || header.version != version) {
+                return false;
+            }
+            std::vector<TableDescriptor> tables(header.table_count);
+            std::vector<FieldDescriptor> fields(header.field_count);
+            file.read(reinterpret_cast<char*>(tables.data()), std::streamsize(tables.size() * sizeof(TableDescriptor)));
+            file.read(reinterpret_cast<char*>(fields.data()), std::streamsize(fields.size() * sizeof(FieldDescriptor)));
+            if (!file) {
+                return false;
+            }
+
+            const auto find = [&](std::string_view name) -> const TableDescriptor* {
+                for (const auto& table : tables) {
+                    if (name_equals(table.name, sizeof(table.name), name) &&
+                        std::uint64_t{table.first_field} + table.field_count <= fields.size()) {
+                        return &table;
+                    }
+                }
+                return nullptr;
+            };
+            const auto fields_of = [&](const TableDescriptor& table) {
+                return std::span<const FieldDescriptor>{fields}.subspan(table.first_field, table.field_count);
+            };
+            const TableDescriptor* grid_table = find("chunk_grid");
+            const TableDescriptor* chunk_table = find("chunks");
+            const TableDescriptor* record_table = find("records");
+            if (!grid_table || !chunk_table || !record_table || grid_table->count != 1 ||
+                !schema_matches<ChunkGrid>(*grid_table, fields_of(*grid_table)) ||
+                !schema_matches<ChunkDescriptor>(*chunk_table, fields_of(*chunk_table)) ||
+                !schema_matches<Record>(*record_table, fields_of(*record_table))) {
+                return false;
+            }
+
+            file.seekg(std::streamoff(grid_table->offset));
+            file.read(reinterpret_cast<char*>(&grid), sizeof(grid));
+            std::vector<ChunkDescriptor> chunks(chunk_table->count);
+            file.seekg(std::streamoff(chunk_table->offset));
+            file.read(reinterpret_cast<char*>(chunks.data()), std::streamsize(chunks.size() * sizeof(ChunkDescriptor)));
+            if (!file || grid.chunk_size <= 0) {
+                return false;
+            }
+            records_offset = record_table->offset;
+            directory.reserve(chunks.size());
+            for (const auto& chunk : chunks) {
+                if (chunk.first + chunk.count > record_table->count) {
+                    return false;
+                }
+                directory.emplace(Cell{chunk.cell_x, chunk.cell_y}, chunk);
+            }
+            return true;
+        }
+
+        float distance_squared(Cell cell, float x, float y) const {
+            const float dx = (float(cell.x) + 0.5f) * grid.chunk_size - x;
+            const float dy = (float(cell.y) + 0.5f) * grid.chunk_size - y;
+            return dx * dx + dy * dy;
+        }
+
+        void load_loop() {
+            std::vector<Cell> wanted;
+            while (true) {
+                float x, y;
+                {
+                    std::unique_lock lock{mutex};
+                    wake.wait(lock, [this] { return stopping || focus_changed || !requests.empty(); });
+                    if (stopping) {
+                        return;
+                    }
+                    focus_changed = false;
+                    x = focus_x;
+                    y = focus_y;
+                    wanted.assign(requests.begin(), requests.end());
+                    requests.clear();
+                    evict_outside(settings.load_radius + settings.unload_margin, x, y);
+                }
+
+                const auto reach = std::int32_t(std::ceil(settings.load_radius / grid.chunk_size));
+                const Cell centre{std::int32_t(std::floor(x / grid.chunk_size)), std::int32_t(std::floor(y / grid.chunk_size))};
+                const float radius_squared = settings.load_radius * settings.load_radius;
+                for (std::int32_t cell_y = centre.y - reach; cell_y <= centre.y + reach; ++cell_y) {
+                    for (std::int32_t cell_x = centre.x - reach; cell_x <= centre.x + reach; ++cell_x) {
+                        const Cell cell{cell_x, cell_y};
+                        if (directory.contains(cell) && distance_squared(cell, x, y) <= radius_squared) {
+                            wanted.push_back(cell);
+                        }
+                    }
+                }
+                std::sort(wanted.begin(), wanted.end(), [&](Cell a, Cell b) {
+                    return distance_squared(a, x, y) < distance_squared(b, x, y);
+                });
+
+                for (const Cell cell : wanted) {
+                    {
+                        std::lock_guard lock{mutex};
+                        if (stopping || focus_changed) {
+                            break;
+                        }
+                        if (resident.contains(cell) || corrupt.contains(cell)) {
+                            continue;
+                        }
+                    }
+                    const ChunkDescriptor& descriptor = directory.at(cell);
+                    const std::size_t bytes = descriptor.count * sizeof(Record);
+                    if (!make_room(bytes, distance_squared(cell, x, y), x, y)) {
+                        break;
+                    }
+                    load(cell, descriptor);
+                }
+            }
+        }
+
+        /**
+         * 🧹 Evict every chunk whose centre is farther than `radius` from the focus. Mutex held.
+         */
+        void evict_outside(float radius, float x, float y) {
+            const float radius_squared = radius * radius;
+            for (auto chunk = resident.begin(); chunk != resident.end();) {
+                if (distance_squared(chunk->first, x, y) <= radius_squared) {
+                    ++chunk;
+                    continue;
+                }
+                resident_bytes -= chunk->second->records.size() * sizeof(Record);
+                chunk = resident.erase(chunk);
+                ++evictions;
+            }
+        }
+
+        /**
+         * 🧹 Evict chunks farther out than `distance` until `bytes` more fit the budget
+         */
+        bool make_room(std::size_t bytes, float distance, float x, float y) {
+            std::lock_guard lock{mutex};
+            while (resident_bytes + bytes > settings.memory_budget) {
+                auto farthest = resident.end();
+                float farthest_distance = distance;
+                for (auto candidate = resident.begin(); candidate != resident.end(); ++candidate) {
+                    const float candidate_distance = distance_squared(candidate->first, x, y);
+                    if (candidate_distance > farthest_distance) {
+                        farthest = candidate;
+                        farthest_distance = candidate_distance;
+                    }
+                }
+                if (farthest == resident.end()) {
+                    return false;
+                }
+                resident_bytes -= farthest->second->records.size() * sizeof(Record);
+                resident.erase(farthest);
+                ++evictions;
+            }
+            return true;
+        }
+
+        void load(Cell cell, const ChunkDescriptor& descriptor) {
+            const auto start = std::chrono::steady_clock::now();
+            auto chunk = std::make_shared<Chunk>(Chunk{cell, descriptor.hash, std::vector<Record>(descriptor.count)});
+            file.seekg(std::streamoff(records_offset + descriptor.first * sizeof(Record)));
+            file.read(reinterpret_cast<char*>(chunk->records.data()), std::streamsize(descriptor.count * sizeof(Record)));
+            if (!file) {
+                std::cerr << "hyper: failed reading chunk " << cell.x << ", " << cell.y << std::endl;
+                file.clear();
+                return;
+            }
+            if (hash_bytes(std::as_bytes(std::span<const Record>{chunk->records})) != descriptor.hash) {
+                std::cerr << "hyper: chunk " << cell.x << ", " << cell.y << " doesn't match its hash, skipping it" << std::endl;
+                std::lock_guard lock{mutex};
+                corrupt.insert(cell);
+                ++rejected;
+                return;
+            }
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            std::lock_guard lock{mutex};
+            resident_bytes += descriptor.count * sizeof(Record);
+            resident.emplace(cell, std::move(chunk));
+            ++loads;
+            load_ms_total += elapsed.count();
+            load_ms_max = std::max(load_ms_max, elapsed.count());
+        }
+    };
+}